@@ -0,0 +1,135 @@
+// 热路径基准：Redis hash 解析、DetailsJSON 编解码、DbRow 取值
+// 构建：cmake -DEAUTOCHECK_BUILD_BENCH=ON ... && ./EAutoCheck_bench
+#include "db/db_row.h"
+#include "device/ccu_codec.h"
+#include "device/ccu_fields.h"
+#include "utils/convert.h"
+
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr int kCcuPerPile = 8; // 典型单桩 CCU 数
+
+// 与现场一致的字段形态："<序号>;<描述>" -> "1"/"2"，外加若干非状态字段
+std::unordered_map<std::string, std::string> MakeRedisHash(int seed) {
+  std::unordered_map<std::string, std::string> hash;
+  for (const auto &field : device::kCcuFields) {
+    const bool on = ((field.redis_index * 7 + seed) % 5) == 0;
+    hash.emplace(std::to_string(field.redis_index) + ";" +
+                     std::string(field.role_name),
+                 on ? "1" : "2");
+  }
+  hash.emplace("comm", "true");
+  hash.emplace("updateTime", "2025-06-01 12:00:00");
+  return hash;
+}
+
+std::vector<device::CCUAttributes> MakeCcus() {
+  std::vector<device::CCUAttributes> ccus;
+  for (int i = 0; i < kCcuPerPile; ++i) {
+    auto attrs = utils::ToCCUAttr(MakeRedisHash(i), i + 1);
+    ccus.push_back(attrs.value());
+  }
+  return ccus;
+}
+
+std::string MakeDetailsJson() {
+  nlohmann::json details; // NOLINT
+  details["deviceId"] = "155261-PILE-01";
+  details["deviceName"] = "终端1";
+  details["deviceType"] = "PILE";
+  std::vector<nlohmann::json> modules;
+  for (const auto &ccu : MakeCcus()) {
+    modules.push_back(device::EncodeCcuModule(ccu));
+  }
+  details["ccuModules"] = modules;
+  return details.dump();
+}
+
+db::DbRow MakeRecordRow() {
+  return db::DbRow(db::DbRow::RawMap{
+      {"ID", "123456789"},
+      {"RecordID", "5f0c1f0e-6a1d-4c43-9b2a-6f2f0f5b8e21"},
+      {"EquipNo", "155261-PILE-01"},
+      {"Status", "WARN"},
+      {"CheckCategory", "FULL"},
+      {"TriggerSource", "AUTO"},
+      {"Summary", "2 issue(s) found"},
+      {"IssueCount", "2"},
+      {"CcuCount", "8"},
+      {"FaultCcuCount", "1"},
+      {"FaultMask", "33619968"},
+      {"CreatedAt", "2025-06-01 12:00:00"},
+  });
+}
+
+void BM_ToCCUAttr(benchmark::State &state) {
+  const auto hash = MakeRedisHash(3);
+  for (auto _ : state) {
+    auto attrs = utils::ToCCUAttr(hash, 1);
+    benchmark::DoNotOptimize(attrs);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(hash.size()));
+}
+BENCHMARK(BM_ToCCUAttr);
+
+void BM_EncodeDetailsJson(benchmark::State &state) {
+  const auto ccus = MakeCcus();
+  for (auto _ : state) {
+    std::vector<nlohmann::json> modules;
+    modules.reserve(ccus.size());
+    for (const auto &ccu : ccus) {
+      modules.push_back(device::EncodeCcuModule(ccu));
+    }
+    nlohmann::json details; // NOLINT
+    details["ccuModules"] = std::move(modules);
+    auto text = details.dump();
+    benchmark::DoNotOptimize(text);
+  }
+  state.SetItemsProcessed(state.iterations() * kCcuPerPile);
+}
+BENCHMARK(BM_EncodeDetailsJson);
+
+// 与 DeviceRepo::DecodeDetailsJson 相同的路径：解析文本 + 逐模块解码
+void BM_DecodeDetailsJson(benchmark::State &state) {
+  const auto text = MakeDetailsJson();
+  for (auto _ : state) {
+    auto details = nlohmann::json::parse(text);
+    std::vector<device::CCUAttributes> ccus;
+    const auto &modules = details["ccuModules"];
+    ccus.reserve(modules.size());
+    for (const auto &module : modules) {
+      ccus.push_back(device::DecodeCcuModule(module));
+    }
+    benchmark::DoNotOptimize(ccus);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(text.size()));
+}
+BENCHMARK(BM_DecodeDetailsJson);
+
+void BM_DbRowAccessors(benchmark::State &state) {
+  const auto row = MakeRecordRow();
+  for (auto _ : state) {
+    auto id = row.getInt64("ID");
+    auto status = row.getString("Status");
+    auto ccu_count = row.getInt("CcuCount");
+    auto mask = row.getInt64("FaultMask");
+    auto summary = row.getNullableString("Summary");
+    benchmark::DoNotOptimize(id);
+    benchmark::DoNotOptimize(status);
+    benchmark::DoNotOptimize(ccu_count);
+    benchmark::DoNotOptimize(mask);
+    benchmark::DoNotOptimize(summary);
+  }
+}
+BENCHMARK(BM_DbRowAccessors);
+
+} // namespace
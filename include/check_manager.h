@@ -9,6 +9,8 @@
 #include <qtmetamacros.h>
 #include <vector>
 
+#include "model/history_model.h"
+
 namespace qml_model {
 class DeviceModel;
 }
@@ -27,6 +29,12 @@ public:
 
   absl::Status SubMsg();
 
+signals:
+  // 自检记录落库后在 UI 线程发出，item.recordId 为 LAST_INSERT_ID
+  void historyRecordSaved(const qml_model::HistoryItem &item,
+                          const QString &checkCategory,
+                          const QString &triggerSource);
+
 private:
   void recvMsg(const std::string &message);
 
@@ -3,10 +3,14 @@
 // ===========================
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <variant>
 #include <vector>
 
@@ -21,8 +25,13 @@
 // absl
 #include <absl/status/statusor.h>
 
+// Qt
+#include <QFuture>
+
 // db
+#include "db/db_executor.h"
 #include "db/db_row.h"
+#include "db/query_metrics.h"
 
 namespace db {
 
@@ -59,6 +68,13 @@ struct Endpoint {
   std::string database;
 };
 
+struct PoolConfig {
+  bool enabled = true;
+  int max_size = 10;            // 最大连接数，同时也是 DbExecutor 线程数
+  int acquire_timeout_ms = 3000; // 取连接超时
+  int keepalive_sec = 60; // 空闲超过该时长的连接在复用前先探活
+};
+
 struct RetryConfig {
   int max_retries = 2;
   int base_backoff_ms = 200;
@@ -67,6 +83,7 @@ struct RetryConfig {
 struct BehaviorConfig {
   std::string timezone = "UTC";
   int slow_sql_ms = 200;
+  int metrics_dump_sec = 300; // SQL 指标周期输出到日志，0 表示关闭
 };
 
 struct Timeouts {
@@ -83,19 +100,46 @@ struct MySqlConfig {
 
 struct Config {
   MySqlConfig mysql;
+  PoolConfig pool;
   RetryConfig retry;
   BehaviorConfig behavior;
 
   static Config FromYamlFile(const std::string &path);
 };
 
+class MySqlClient;
+
 // ---------------------------
-// Internal helpers (opaque in header)
+// Transaction
 // ---------------------------
-// Simple connection holder - no pool needed
+// 由 MySqlClient::runInTransaction 创建，所有语句在同一连接上执行
+// 语句失败不会自动重试（部分执行的事务不可重放），由 runInTransaction 回滚
+class Transaction {
+public:
+  Transaction(const Transaction &) = delete;
+  Transaction &operator=(const Transaction &) = delete;
+
+  absl::StatusOr<std::vector<DbRow>>
+  query(const std::string &sql, const std::vector<DbValue> &params = {});
+
+  absl::StatusOr<uint64_t> update(const std::string &sql,
+                                  const std::vector<DbValue> &params = {});
+
+  // 本连接上最近一次 INSERT 生成的自增 ID
+  absl::StatusOr<int64_t> lastInsertId();
+
+private:
+  friend class MySqlClient;
+  Transaction(MySqlClient *owner, sql::Connection *conn)
+      : owner_(owner), conn_(conn) {}
+
+  MySqlClient *owner_;
+  sql::Connection *conn_;
+  int last_error_code_ = 0; // 最近一次失败的 MySQL 错误码，用于判断是否可重试
+};
 
 // ---------------------------
-// Public client (sync)
+// Public client (sync + async)
 // ---------------------------
 class MySqlClient {
 public:
@@ -122,18 +166,62 @@ public:
   executeUpdate(const std::string &sql,
                 const std::vector<DbValue> &params = {});
 
+  // 异步版本：在 DbExecutor 上执行，按 priority 排队
+  QFuture<absl::StatusOr<std::vector<DbRow>>>
+  executeQueryAsync(std::string sql, std::vector<DbValue> params = {},
+                    QueryPriority priority = QueryPriority::kNormal);
+
+  QFuture<absl::StatusOr<uint64_t>>
+  executeUpdateAsync(std::string sql, std::vector<DbValue> params = {},
+                     QueryPriority priority = QueryPriority::kNormal);
+
+  // 在单个连接上执行事务：fn 返回 OK 则提交，否则回滚并返回其错误
+  // 死锁 / 锁等待超时时整体重试（最多 retry.max_retries 次），fn 需可重入
+  absl::Status
+  runInTransaction(const std::function<absl::Status(Transaction &)> &fn);
+
   // Utility: simple ping
   absl::Status ping();
 
-private:
-  void ensureConnection();
-  void ensureConnectionUnlocked(); // Internal version without lock
-  void reconnect();
+  // 按语句指纹聚合的耗时/行数/错误统计，运行时可随时查询
+  const QueryMetrics &metrics() const { return metrics_; }
+  QueryMetrics &metrics() { return metrics_; }
 
-  std::unique_ptr<sql::Connection> connection_;
-  std::mutex connection_mutex_;
+private:
+  friend class Transaction;
+
+  // RAII 连接租约：析构时归还连接池，discard() 后直接丢弃
+  class ConnectionLease;
+
+  ConnectionLease acquireConnection();
+  std::unique_ptr<sql::Connection> createConnection();
+  void releaseConnection(std::unique_ptr<sql::Connection> conn,
+                         bool reusable);
+  void reconnect(); // 丢弃所有空闲连接，下次使用时重建
+  void logStatement(const std::string &sql,
+                    std::chrono::steady_clock::time_point start,
+                    std::chrono::steady_clock::time_point end,
+                    const char *what, uint64_t count) const;
+
+  struct IdleConnection {
+    std::unique_ptr<sql::Connection> conn;
+    std::chrono::steady_clock::time_point last_used;
+  };
+
+  std::vector<IdleConnection> idle_; // 空闲连接（LIFO，优先复用最热的）
+  int open_count_ = 0;               // 已建立的连接总数（空闲 + 借出）
+  std::mutex pool_mutex_;
+  std::condition_variable pool_cv_;
   Config cfg_;
 
+  void metricsDumpLoop();
+
+  QueryMetrics metrics_;
+  std::thread metrics_thread_;
+  std::mutex metrics_thread_mutex_;
+  std::condition_variable metrics_thread_cv_;
+  bool stopping_ = false;
+
   static std::unique_ptr<MySqlClient> instance_;
   static std::mutex instance_mutex_;
 };
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QFuture>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <type_traits>
+#include <utility>
+
+namespace db {
+
+// 查询优先级：数值越大越先出队（QThreadPool 按优先级调度排队中的任务）
+enum class QueryPriority : int {
+  kBackground = 0,   // 启动预加载、周期维护等后台任务
+  kNormal = 5,       // 默认
+  kInteractive = 10, // UI 交互触发的加载（历史页、详情页）
+};
+
+// 数据库专用执行器
+// - 独立于全局 QThreadPool，阻塞的 MySQL 调用不会占满全局线程池
+// - 线程数与连接池大小一致（MySqlClient::Init 时设置），任务取到线程即可取到连接
+class DbExecutor {
+public:
+  static QThreadPool *Pool();
+
+  // 设置线程数（通常等于连接池 max_size）
+  static void SetMaxThreads(int max_threads);
+
+  // 等待所有已提交任务结束，用于退出前关闭连接池
+  static bool WaitForDone(int timeout_ms = -1);
+
+  // 在数据库线程池上执行任意阻塞的 DB 工作，返回 QFuture
+  template <typename Fn>
+  static auto Submit(QueryPriority priority, Fn &&fn)
+      -> QFuture<std::invoke_result_t<std::decay_t<Fn>>> {
+    return QtConcurrent::task(std::forward<Fn>(fn))
+        .onThreadPool(*Pool())
+        .withPriority(static_cast<int>(priority))
+        .spawn();
+  }
+};
+
+} // namespace db
@@ -1,9 +1,33 @@
 #pragma once
 
 #include <absl/status/status.h>
+#include <absl/status/statusor.h>
+#include <string>
 
 namespace db {
 
 absl::Status CreateSelfCheckRecordTable();
 
+// 按版本号顺序执行 schema 迁移
+// - 已执行的版本记录在 schema_version 表中，启动时只执行更高版本
+// - 每个迁移自身幂等（先检查索引/列是否存在），中途失败可安全重跑
+absl::Status RunSchemaMigrations();
+
+class Transaction;
+
+// 将本连接最近插入的 self_check_record（LAST_INSERT_ID()）累加到
+// self_check_daily_rollup，必须与插入语句在同一事务内调用
+absl::Status AccumulateDailyRollup(Transaction &tx);
+
+// 由 DetailsJSON 计算故障摘要列的查询（按 s.ID 分组，列名 CcuCount /
+// FaultCcuCount / AcFaults / ParFaults / FanFaults / GunFaults / FaultMask），
+// where 为作用于 self_check_record s 的条件。摘要列尚未回填的记录读取时同样使用
+std::string FaultSummarySelectSql(const std::string &where);
+
+// 分批回填迁移 v2 加列前写入记录的故障摘要列（每批 batch_size 个 ID）
+// - 进度记录在 schema_backfill 表中，重启后续跑；多实例并发执行只会重复写入相同值
+// - 全部完成后由明细重建全部历史的日汇总
+// 返回是否还有剩余批次；应在后台低优先级调用，不要放在启动路径上
+absl::StatusOr<bool> BackfillFaultSummaryBatch(int batch_size = 1000);
+
 } // namespace db
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <absl/status/status.h>
+#include <yaml-cpp/yaml.h>
+
+#include <QThread>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace db {
+
+class MySqlClient;
+
+struct MaintenanceConfig {
+  bool enabled = false;       // 默认关闭，需在配置中显式开启
+  bool convert_table = false; // 表未分区时是否自动转换（重建整表，阻塞写入）
+  int retention_months = 0;   // 保留最近 N 个月（含当月），更早的分区归档后删除；0 不清理
+  bool archive = true;        // 删除前先复制到 self_check_record_archive
+  int future_partitions = 3;  // 提前创建的未来月份分区数
+  int interval_hours = 24;    // 巡检周期
+  int initial_delay_sec = 60; // 启动后延迟执行，避开启动期的查询高峰
+
+  static MaintenanceConfig FromYaml(const YAML::Node &node);
+};
+
+// self_check_record 分区维护
+// - convert_table 开启时，首次运行将表转换为按 CreatedAt 的月度 RANGE 分区
+//   （主键扩展为 (ID, CreatedAt)）；否则未分区的表只记录警告，不做任何修改
+// - 通过拆分 pmax 提前创建未来月份分区
+// - 超过保留期的分区归档（可选）后 DROP PARTITION，索引大小随之回收
+// - 在最低优先级的独立线程上运行，长时间的 ALTER 不占用 DbExecutor 线程
+class PartitionMaintainer {
+public:
+  static void Init(const MaintenanceConfig &cfg);
+  static void Shutdown();
+  static PartitionMaintainer *GetInstance();
+
+  PartitionMaintainer(const PartitionMaintainer &) = delete;
+  PartitionMaintainer &operator=(const PartitionMaintainer &) = delete;
+  ~PartitionMaintainer();
+
+  // 执行一次完整的维护（转换 / 预建 / 归档删除），同步阻塞
+  absl::Status runOnce();
+
+private:
+  explicit PartitionMaintainer(const MaintenanceConfig &cfg);
+
+  void loop();
+  absl::Status ensurePartitioned(MySqlClient *client);
+  absl::Status ensureFuturePartitions(MySqlClient *client);
+  absl::Status enforceRetention(MySqlClient *client);
+  absl::Status ensureArchiveTable(MySqlClient *client);
+
+  MaintenanceConfig cfg_;
+  QThread *thread_ = nullptr;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_ = false;
+
+  static std::unique_ptr<PartitionMaintainer> instance_;
+  static std::mutex instance_mutex_;
+};
+
+} // namespace db
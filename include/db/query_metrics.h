@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace db {
+
+// HDR 风格的对数-线性直方图（单位：微秒）
+// 每个 2 的幂区间再均分 16 个子桶，相对误差 < 6.25%，记录 O(1)、内存固定
+class LatencyHistogram {
+public:
+  static constexpr int kSubBucketBits = 4;
+  static constexpr int kSubBucketCount = 1 << kSubBucketBits;
+  static constexpr int kMaxValueBits = 40; // 上限约 12.7 天
+  static constexpr int kBucketCount =
+      kSubBucketCount * (kMaxValueBits - kSubBucketBits) + kSubBucketCount;
+
+  void record(std::uint64_t value_us);
+  void merge(const LatencyHistogram &other);
+
+  std::uint64_t count() const { return total_count_; }
+  std::uint64_t sum() const { return sum_; }
+  std::uint64_t max() const { return max_; }
+
+  // p: 0~100，返回所在桶的上界（不超过实际最大值）
+  std::uint64_t percentile(double p) const;
+
+private:
+  static int bucketIndex(std::uint64_t value);
+  static std::uint64_t bucketLowerBound(int index);
+
+  std::array<std::uint64_t, kBucketCount> counts_{};
+  std::uint64_t total_count_ = 0;
+  std::uint64_t sum_ = 0;
+  std::uint64_t max_ = 0;
+};
+
+// 单次 SQL 执行的分段耗时
+struct QueryTiming {
+  std::chrono::microseconds acquire_wait{0}; // 等待连接池
+  std::chrono::microseconds prepare{0};      // 创建/预编译语句 + 绑定参数
+  std::chrono::microseconds execute{0};      // 服务端执行
+  std::chrono::microseconds fetch{0};        // 拉取并转换结果集
+  std::chrono::microseconds total{0};        // 含重试的总耗时
+};
+
+// 对外暴露的统计快照（耗时单位：毫秒）
+struct StatementSnapshot {
+  std::string origin;      // 调用方标记，如 "HistoryPage"
+  std::string fingerprint; // 归一化后的语句
+  std::uint64_t count = 0;
+  std::uint64_t errors = 0;
+  std::uint64_t rows = 0;
+  double total_ms = 0;
+  double p50_ms = 0;
+  double p95_ms = 0;
+  double p99_ms = 0;
+  double max_ms = 0;
+  double acquire_p95_ms = 0;
+  double prepare_p95_ms = 0;
+  double fetch_p95_ms = 0;
+};
+
+// 按语句指纹聚合的 SQL 指标
+class QueryMetrics {
+public:
+  // 归一化 SQL：字面量替换为 ?，IN 列表折叠为 ?+，空白折叠为单个空格
+  static std::string Fingerprint(std::string_view sql);
+
+  void record(std::string_view sql, const QueryTiming &timing,
+              std::uint64_t rows, bool ok);
+
+  // 按总耗时降序
+  std::vector<StatementSnapshot> snapshot() const;
+
+  // 文本报表（用于周期性日志输出）
+  std::string report(std::size_t top_n = 20) const;
+
+  void reset();
+
+private:
+  struct StatementStats {
+    std::string origin;
+    std::string fingerprint;
+    std::uint64_t count = 0;
+    std::uint64_t errors = 0;
+    std::uint64_t rows = 0;
+    LatencyHistogram latency;
+    LatencyHistogram acquire_wait;
+    LatencyHistogram prepare;
+    LatencyHistogram fetch;
+  };
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, StatementStats> stats_; // key: origin|fp
+};
+
+// 为当前线程上的查询打上调用方标记（RAII，可嵌套）
+// 用于定位是哪个页面/任务在频繁访问数据库
+class ScopedQueryOrigin {
+public:
+  explicit ScopedQueryOrigin(const char *origin);
+  ~ScopedQueryOrigin();
+
+  ScopedQueryOrigin(const ScopedQueryOrigin &) = delete;
+  ScopedQueryOrigin &operator=(const ScopedQueryOrigin &) = delete;
+
+  static const char *Current();
+
+private:
+  const char *previous_;
+};
+
+} // namespace db
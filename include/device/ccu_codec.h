@@ -0,0 +1,15 @@
+#pragma once
+
+#include "device/device_object.h"
+#include <nlohmann/json_fwd.hpp>
+
+namespace device {
+
+// DetailsJSON 中单个 ccuModules 元素的编解码，字段由 kCcuFields 生成：
+// {"index": 1, "acContactor1": {"refuse": false, "stuck": true}, ...}
+nlohmann::json EncodeCcuModule(const CCUAttributes &attrs);
+
+// 缺失或类型不符的字段视为 false；不填充设备元信息
+CCUAttributes DecodeCcuModule(const nlohmann::json &module);
+
+} // namespace device
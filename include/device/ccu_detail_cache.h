@@ -0,0 +1,98 @@
+#pragma once
+
+#include "device/device_object.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace device {
+
+using CcuDetails = std::vector<CCUAttributes>;
+using CcuDetailsPtr = std::shared_ptr<const CcuDetails>;
+
+struct CcuDetailCacheStats {
+  std::uint64_t hits = 0;
+  std::uint64_t misses = 0;
+  std::uint64_t evictions = 0;
+  std::size_t entries = 0;
+  std::size_t bytes = 0;          // 估算占用
+  std::size_t capacity_bytes = 0; // 上限
+
+  double hitRate() const {
+    const auto total = hits + misses;
+    return total == 0 ? 0.0 : static_cast<double>(hits) / total;
+  }
+};
+
+// 已解码的 CCU 详情缓存（按 recordId）
+// - self_check_record 写入后不再修改，按记录 ID 缓存的内容永不过期，只按 LRU 淘汰
+// - 按估算字节数限制总大小，而不是条目数（不同设备 CCU 数量差异很大）
+// - 另记录每台设备最新记录 ID，新记录写入时由 CheckManager 调用 invalidateLatest
+// - 线程安全：DbExecutor 多线程并发读写
+class CcuDetailCache {
+public:
+  static constexpr std::size_t kDefaultCapacityBytes = 16 * 1024 * 1024;
+
+  static CcuDetailCache &Instance();
+
+  explicit CcuDetailCache(std::size_t capacity_bytes = kDefaultCapacityBytes);
+
+  CcuDetailCache(const CcuDetailCache &) = delete;
+  CcuDetailCache &operator=(const CcuDetailCache &) = delete;
+
+  // 命中时提升为最近使用；未命中返回 nullptr
+  CcuDetailsPtr get(std::int64_t record_id);
+  void put(std::int64_t record_id, CcuDetailsPtr details);
+  // 只判断是否已缓存：不计入命中统计，也不调整 LRU 顺序（预取判重用）
+  bool contains(std::int64_t record_id) const;
+
+  // 设备最新记录 ID（未知或已失效返回 nullopt）
+  // epoch 输出当前失效代数，查询到最新 ID 后连同 epoch 回写，
+  // 期间若有新记录写入（invalidateLatest）则回写被忽略，避免缓存旧 ID
+  std::optional<std::int64_t> latestRecordId(const std::string &equip_no,
+                                             std::uint64_t *epoch = nullptr);
+  void setLatestRecordId(const std::string &equip_no, std::int64_t record_id,
+                         std::uint64_t epoch);
+  void invalidateLatest(const std::string &equip_no);
+
+  void setCapacityBytes(std::size_t capacity_bytes);
+  void clear();
+
+  CcuDetailCacheStats stats() const;
+  std::string report() const;
+
+  // 估算一条记录解码后的内存占用
+  static std::size_t EstimateBytes(const CcuDetails &details);
+
+private:
+  struct Entry {
+    std::int64_t record_id;
+    CcuDetailsPtr details;
+    std::size_t bytes;
+  };
+
+  void evictLocked();
+
+  mutable std::mutex mutex_;
+  std::list<Entry> lru_; // 头部为最近使用
+  std::unordered_map<std::int64_t, std::list<Entry>::iterator> index_;
+  struct Latest {
+    std::optional<std::int64_t> record_id;
+    std::uint64_t epoch = 0;
+  };
+  std::unordered_map<std::string, Latest> latest_;
+
+  std::size_t capacity_bytes_;
+  std::size_t bytes_ = 0;
+  std::uint64_t hits_ = 0;
+  std::uint64_t misses_ = 0;
+  std::uint64_t evictions_ = 0;
+};
+
+} // namespace device
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "device/device_object.h"
+#include <cstdint>
+#include <vector>
+
+namespace device {
+
+// 一次自检记录的故障统计，写入 self_check_record 的摘要列，
+// 列表/看板直接读列，无需解析 DetailsJSON
+struct FaultSummary {
+  int ccu_count = 0;
+  int fault_ccu_count = 0;           // 至少存在一项故障的 CCU 数
+  int ac_contactor_faults = 0;       // 交流接触器粘连/拒动
+  int parallel_contactor_faults = 0; // 并联接触器粘连/拒动
+  int fan_faults = 0;                // 风扇停转
+  int gun_faults = 0;                // 枪正负极接触器粘连/拒动
+  // 所有 CCU 故障位的并集，即 CCUAttributes::flags & ccu_flag::kAllFaults
+  std::uint32_t fault_mask = 0;
+
+  int total() const {
+    return ac_contactor_faults + parallel_contactor_faults + fan_faults +
+           gun_faults;
+  }
+};
+
+FaultSummary SummarizeFaults(const std::vector<CCUAttributes> &ccus);
+
+} // namespace device
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "device/device_object.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace device {
+
+// CCU 状态位所属部件，对应 FaultSummary 的分类计数
+enum class CcuCategory { AcContactor, ParallelContactor, Fan, Gun };
+
+// 单个 CCU 状态位的描述
+// 所有编解码（Redis / DetailsJSON / QML role / 故障统计）都遍历同一张表，
+// 新增或调整字段只改这里
+struct CcuFieldDesc {
+  int redis_index;             // Redis 字段序号 "<index>;..."，也是故障掩码位号
+  std::string_view json_group; // DetailsJSON 中的模块对象，如 "acContactor1"
+  std::string_view json_key;   // 模块对象内的键，如 "stuck"
+  std::string_view role_name;  // PileModel 的 role 名，如 "ac1_stuck"
+  CcuCategory category;
+  FaultLevel severity; // None 表示状态反馈（转动/上锁/辅源），不计入故障
+
+  constexpr std::uint32_t mask() const { return 1u << redis_index; }
+  bool get(const CCUAttributes &attrs) const { return attrs.test(mask()); }
+  void set(CCUAttributes &attrs, bool value) const {
+    attrs.set(mask(), value);
+  }
+  bool isFault() const { return severity != FaultLevel::None; }
+};
+
+// 按 redis_index 升序排列，下标即序号
+inline constexpr std::array<CcuFieldDesc, 32> kCcuFields = {{
+    {0, "acContactor1", "refuse", "ac1_refuse", CcuCategory::AcContactor,
+     FaultLevel::Error},
+    {1, "acContactor1", "stuck", "ac1_stuck", CcuCategory::AcContactor,
+     FaultLevel::Error},
+    {2, "acContactor2", "refuse", "ac2_refuse", CcuCategory::AcContactor,
+     FaultLevel::Error},
+    {3, "acContactor2", "stuck", "ac2_stuck", CcuCategory::AcContactor,
+     FaultLevel::Error},
+
+    {4, "parallelContactor", "positiveRefuse", "par_pos_refuse",
+     CcuCategory::ParallelContactor, FaultLevel::Error},
+    {5, "parallelContactor", "positiveStuck", "par_pos_stuck",
+     CcuCategory::ParallelContactor, FaultLevel::Error},
+    {6, "parallelContactor", "negativeRefuse", "par_neg_refuse",
+     CcuCategory::ParallelContactor, FaultLevel::Error},
+    {7, "parallelContactor", "negativeStuck", "par_neg_stuck",
+     CcuCategory::ParallelContactor, FaultLevel::Error},
+
+    {8, "fan1", "stopped", "fan1_stopped", CcuCategory::Fan,
+     FaultLevel::Error},
+    {9, "fan1", "rotating", "fan1_rotating", CcuCategory::Fan,
+     FaultLevel::None},
+    {10, "fan2", "stopped", "fan2_stopped", CcuCategory::Fan,
+     FaultLevel::Error},
+    {11, "fan2", "rotating", "fan2_rotating", CcuCategory::Fan,
+     FaultLevel::None},
+    {12, "fan3", "stopped", "fan3_stopped", CcuCategory::Fan,
+     FaultLevel::Error},
+    {13, "fan3", "rotating", "fan3_rotating", CcuCategory::Fan,
+     FaultLevel::None},
+    {14, "fan4", "stopped", "fan4_stopped", CcuCategory::Fan,
+     FaultLevel::Error},
+    {15, "fan4", "rotating", "fan4_rotating", CcuCategory::Fan,
+     FaultLevel::None},
+
+    {16, "gunA", "positiveContactorRefuse", "gunA_pos_refuse",
+     CcuCategory::Gun, FaultLevel::Error},
+    {17, "gunA", "positiveContactorStuck", "gunA_pos_stuck", CcuCategory::Gun,
+     FaultLevel::Error},
+    {18, "gunA", "negativeContactorRefuse", "gunA_neg_refuse",
+     CcuCategory::Gun, FaultLevel::Error},
+    {19, "gunA", "negativeContactorStuck", "gunA_neg_stuck", CcuCategory::Gun,
+     FaultLevel::Error},
+    {20, "gunA", "unlocked", "gunA_unlocked", CcuCategory::Gun,
+     FaultLevel::None},
+    {21, "gunA", "locked", "gunA_locked", CcuCategory::Gun, FaultLevel::None},
+    {22, "gunA", "auxPower12v", "gunA_aux12", CcuCategory::Gun,
+     FaultLevel::None},
+    {23, "gunA", "auxPower24v", "gunA_aux24", CcuCategory::Gun,
+     FaultLevel::None},
+
+    {24, "gunB", "positiveContactorRefuse", "gunB_pos_refuse",
+     CcuCategory::Gun, FaultLevel::Error},
+    {25, "gunB", "positiveContactorStuck", "gunB_pos_stuck", CcuCategory::Gun,
+     FaultLevel::Error},
+    {26, "gunB", "negativeContactorRefuse", "gunB_neg_refuse",
+     CcuCategory::Gun, FaultLevel::Error},
+    {27, "gunB", "negativeContactorStuck", "gunB_neg_stuck", CcuCategory::Gun,
+     FaultLevel::Error},
+    {28, "gunB", "unlocked", "gunB_unlocked", CcuCategory::Gun,
+     FaultLevel::None},
+    {29, "gunB", "locked", "gunB_locked", CcuCategory::Gun, FaultLevel::None},
+    {30, "gunB", "auxPower12v", "gunB_aux12", CcuCategory::Gun,
+     FaultLevel::None},
+    {31, "gunB", "auxPower24v", "gunB_aux24", CcuCategory::Gun,
+     FaultLevel::None},
+}};
+
+inline constexpr std::size_t kCcuFieldCount = kCcuFields.size();
+
+namespace detail {
+constexpr bool CcuFieldsIndexed() {
+  for (std::size_t i = 0; i < kCcuFields.size(); ++i) {
+    if (kCcuFields[i].redis_index != static_cast<int>(i))
+      return false;
+  }
+  return true;
+}
+
+// 表中某一分类的故障位
+constexpr std::uint32_t CcuFaultMaskOf(CcuCategory category) {
+  std::uint32_t mask = 0;
+  for (const auto &field : kCcuFields) {
+    if (field.category == category && field.severity != FaultLevel::None)
+      mask |= field.mask();
+  }
+  return mask;
+}
+} // namespace detail
+
+// 某一分类的全部状态位（含转动/上锁等非故障反馈位）
+constexpr std::uint32_t CcuCategoryMask(CcuCategory category) {
+  std::uint32_t mask = 0;
+  for (const auto &field : kCcuFields) {
+    if (field.category == category)
+      mask |= field.mask();
+  }
+  return mask;
+}
+
+// 计入故障的字段数（详情页“正常/异常”统计的分母）
+constexpr int CcuFaultFieldCount() {
+  int count = 0;
+  for (const auto &field : kCcuFields) {
+    count += field.isFault() ? 1 : 0;
+  }
+  return count;
+}
+
+static_assert(detail::CcuFieldsIndexed(),
+              "kCcuFields must be ordered by redis_index");
+// 描述表与 ccu_flag 中手写的分组掩码必须一致
+static_assert(detail::CcuFaultMaskOf(CcuCategory::AcContactor) ==
+              ccu_flag::kAcContactorFaults);
+static_assert(detail::CcuFaultMaskOf(CcuCategory::ParallelContactor) ==
+              ccu_flag::kParallelContactorFaults);
+static_assert(detail::CcuFaultMaskOf(CcuCategory::Fan) ==
+              ccu_flag::kFanFaults);
+static_assert(detail::CcuFaultMaskOf(CcuCategory::Gun) ==
+              ccu_flag::kGunFaults);
+
+// 对每个字段描述调用 fn(const CcuFieldDesc &)
+template <typename Fn> constexpr void ForEachCcuField(Fn &&fn) {
+  for (const auto &field : kCcuFields)
+    fn(field);
+}
+
+} // namespace device
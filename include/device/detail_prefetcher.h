@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace device {
+
+// 设备详情预取：在操作员打开详情页之前，把设备最新记录的 CCU 详情预热进
+// CcuDetailCache，详情页（PileModel::loadFromDevice）直接命中缓存
+// - 来源按优先级：悬停/按下的卡片 > 最近查看的设备 > 可见区域内的卡片
+// - 后台优先级提交到 DbExecutor，同时在途的任务数有上限，不挤占交互查询的连接
+// - 只在 UI 线程调用；已缓存或在途的设备直接跳过
+class DetailPrefetcher : public QObject {
+  Q_OBJECT
+
+public:
+  enum Reason {
+    Visible = 0, // 出现在可见区域
+    Recent,      // 最近查看过
+    Hovered,     // 鼠标悬停 / 按下
+  };
+  Q_ENUM(Reason)
+
+  static constexpr int kMaxInFlight = 2;
+  static constexpr std::size_t kMaxHovered = 8;
+  static constexpr std::size_t kMaxVisible = 64;
+  static constexpr std::size_t kMaxRecent = 8;
+
+  explicit DetailPrefetcher(QObject *parent = nullptr);
+
+  DetailPrefetcher(const DetailPrefetcher &) = delete;
+  DetailPrefetcher &operator=(const DetailPrefetcher &) = delete;
+
+  // 单台设备的预取提示
+  Q_INVOKABLE void hint(const QString &equipNo, Reason reason);
+  // 替换可见区域的设备列表（滚动停下后调用），滚出视野的设备不再预取
+  Q_INVOKABLE void setVisible(const QStringList &equipNos);
+  // 打开详情页时调用：记入最近查看，其新记录写入后会被重新预热
+  Q_INVOKABLE void markViewed(const QString &equipNo);
+
+  // 设备写入了新记录（最新记录缓存已失效）
+  void onRecordSaved(const QString &equipNo);
+
+  int inFlight() const { return static_cast<int>(in_flight_.size()); }
+
+private:
+  // 按优先级取下一台需要预取的设备，直到达到在途上限
+  void pump();
+  bool takeNext(std::string *equip_no);
+  void dispatch(const std::string &equip_no);
+
+  std::deque<std::string> hovered_; // 头部为最近悬停
+  std::deque<std::string> recent_queue_;
+  std::deque<std::string> visible_;
+  std::deque<std::string> recent_; // 最近查看的设备，头部为最近
+  std::unordered_set<std::string> in_flight_;
+  std::unordered_set<std::string> no_record_; // 查询过、尚无自检记录的设备
+};
+
+} // namespace device
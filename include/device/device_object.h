@@ -1,13 +1,19 @@
 #pragma once
 
+#include <bit>
 #include <chrono>
 #include <cstdint>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace device {
 
+// 设备句柄：进程内稠密编号，从 0 开始、只增不复用（见 DeviceRegistry）
+using DeviceHandle = std::uint32_t;
+inline constexpr DeviceHandle kInvalidDeviceHandle = 0xFFFFFFFFu;
+
 enum DeviceTypes {
   kPILE = 1,
   kSTACK = 2,
@@ -180,44 +186,132 @@ struct GunStatus {
   }
 };
 
-// CCU 属性结构体
-struct CCUAttributes {
-  int index = 0;
-
-  // 设备元信息（同一个记录的所有 CCU 共享）
+// CCU 状态位掩码，位号与 Redis 字段序号一致（字段描述见 device/ccu_fields.h）
+namespace ccu_flag {
+inline constexpr std::uint32_t kAc1Refuse = 1u << 0;
+inline constexpr std::uint32_t kAc1Stuck = 1u << 1;
+inline constexpr std::uint32_t kAc2Refuse = 1u << 2;
+inline constexpr std::uint32_t kAc2Stuck = 1u << 3;
+inline constexpr std::uint32_t kParPosRefuse = 1u << 4;
+inline constexpr std::uint32_t kParPosStuck = 1u << 5;
+inline constexpr std::uint32_t kParNegRefuse = 1u << 6;
+inline constexpr std::uint32_t kParNegStuck = 1u << 7;
+inline constexpr std::uint32_t kFan1Stopped = 1u << 8;
+inline constexpr std::uint32_t kFan1Rotating = 1u << 9;
+inline constexpr std::uint32_t kFan2Stopped = 1u << 10;
+inline constexpr std::uint32_t kFan2Rotating = 1u << 11;
+inline constexpr std::uint32_t kFan3Stopped = 1u << 12;
+inline constexpr std::uint32_t kFan3Rotating = 1u << 13;
+inline constexpr std::uint32_t kFan4Stopped = 1u << 14;
+inline constexpr std::uint32_t kFan4Rotating = 1u << 15;
+inline constexpr std::uint32_t kGunAPosRefuse = 1u << 16;
+inline constexpr std::uint32_t kGunAPosStuck = 1u << 17;
+inline constexpr std::uint32_t kGunANegRefuse = 1u << 18;
+inline constexpr std::uint32_t kGunANegStuck = 1u << 19;
+inline constexpr std::uint32_t kGunAUnlocked = 1u << 20;
+inline constexpr std::uint32_t kGunALocked = 1u << 21;
+inline constexpr std::uint32_t kGunAAux12v = 1u << 22;
+inline constexpr std::uint32_t kGunAAux24v = 1u << 23;
+inline constexpr std::uint32_t kGunBPosRefuse = 1u << 24;
+inline constexpr std::uint32_t kGunBPosStuck = 1u << 25;
+inline constexpr std::uint32_t kGunBNegRefuse = 1u << 26;
+inline constexpr std::uint32_t kGunBNegStuck = 1u << 27;
+inline constexpr std::uint32_t kGunBUnlocked = 1u << 28;
+inline constexpr std::uint32_t kGunBLocked = 1u << 29;
+inline constexpr std::uint32_t kGunBAux12v = 1u << 30;
+inline constexpr std::uint32_t kGunBAux24v = 1u << 31;
+
+// 按部件分组的故障位（不含转动/上锁/辅源等状态反馈）
+inline constexpr std::uint32_t kAcContactorFaults =
+    kAc1Refuse | kAc1Stuck | kAc2Refuse | kAc2Stuck;
+inline constexpr std::uint32_t kParallelContactorFaults =
+    kParPosRefuse | kParPosStuck | kParNegRefuse | kParNegStuck;
+inline constexpr std::uint32_t kFanFaults =
+    kFan1Stopped | kFan2Stopped | kFan3Stopped | kFan4Stopped;
+inline constexpr std::uint32_t kGunFaults =
+    kGunAPosRefuse | kGunAPosStuck | kGunANegRefuse | kGunANegStuck |
+    kGunBPosRefuse | kGunBPosStuck | kGunBNegRefuse | kGunBNegStuck;
+inline constexpr std::uint32_t kAllFaults =
+    kAcContactorFaults | kParallelContactorFaults | kFanFaults | kGunFaults;
+} // namespace ccu_flag
+
+// 一条检查记录的设备元信息，同一记录的所有 CCU 共享一份
+struct CcuRecordMeta {
   std::string device_id;       // 设备ID
   std::string device_name;     // 设备名称
   std::string device_type;     // 设备类型，例如 PILE / STACK
   std::string last_check_time; // 最近检查时间字符串
+};
 
-  ACContactorStatus ac_contactor_1;
-  ACContactorStatus ac_contactor_2;
+// CCU 属性：32 个状态位打包为一个 flags 字，元信息按记录共享
+struct CCUAttributes {
+  int index = 0;
+  std::uint32_t flags = 0; // ccu_flag::k* 的组合
+  std::shared_ptr<const CcuRecordMeta> meta;
 
-  ParallelContactorStatus parallel_contactor;
+  bool test(std::uint32_t mask) const { return (flags & mask) != 0; }
+  void set(std::uint32_t mask, bool value) {
+    flags = value ? (flags | mask) : (flags & ~mask);
+  }
 
-  FanStatus fan_1;
-  FanStatus fan_2;
-  FanStatus fan_3;
-  FanStatus fan_4;
+  // 本 CCU 的故障位数 / 某组故障位数
+  int faultCount(std::uint32_t group = ccu_flag::kAllFaults) const {
+    return std::popcount(flags & group);
+  }
 
-  GunStatus gun_a;
-  GunStatus gun_b;
+  // ---- 兼容访问器 ----
+  const std::string &device_id() const { return metaOrEmpty().device_id; }
+  const std::string &device_name() const { return metaOrEmpty().device_name; }
+  const std::string &device_type() const { return metaOrEmpty().device_type; }
+  const std::string &last_check_time() const {
+    return metaOrEmpty().last_check_time;
+  }
+
+  ACContactorStatus ac_contactor_1() const {
+    return {test(ccu_flag::kAc1Stuck), test(ccu_flag::kAc1Refuse)};
+  }
+  ACContactorStatus ac_contactor_2() const {
+    return {test(ccu_flag::kAc2Stuck), test(ccu_flag::kAc2Refuse)};
+  }
+  ParallelContactorStatus parallel_contactor() const {
+    return {test(ccu_flag::kParPosStuck), test(ccu_flag::kParPosRefuse),
+            test(ccu_flag::kParNegStuck), test(ccu_flag::kParNegRefuse)};
+  }
+  FanStatus fan_1() const { return fanAt(8); }
+  FanStatus fan_2() const { return fanAt(10); }
+  FanStatus fan_3() const { return fanAt(12); }
+  FanStatus fan_4() const { return fanAt(14); }
+  GunStatus gun_a() const { return gunAt(16); }
+  GunStatus gun_b() const { return gunAt(24); }
 
   friend std::ostream &operator<<(std::ostream &output_stream,
                                   const CCUAttributes &attr) {
     output_stream << "CCUAttributes{"
-                  << "index=" << attr.index << ", device_id=" << attr.device_id
-                  << ", device_name=" << attr.device_name
-                  << ", device_type=" << attr.device_type
-                  << ", ac_contactor_1=" << attr.ac_contactor_1
-                  << ", ac_contactor_2=" << attr.ac_contactor_2
-                  << ", parallel_contactor=" << attr.parallel_contactor
-                  << ", fan_1=" << attr.fan_1 << ", fan_2=" << attr.fan_2
-                  << ", fan_3=" << attr.fan_3 << ", fan_4=" << attr.fan_4
-                  << ", gun_a=" << attr.gun_a << ", gun_b=" << attr.gun_b
-                  << "}";
+                  << "index=" << attr.index
+                  << ", device_id=" << attr.device_id()
+                  << ", device_name=" << attr.device_name()
+                  << ", device_type=" << attr.device_type() << ", flags=0x"
+                  << std::hex << attr.flags << std::dec
+                  << ", faults=" << attr.faultCount() << "}";
     return output_stream;
   }
+
+private:
+  FanStatus fanAt(int bit) const {
+    return {test(1u << bit), test(1u << (bit + 1))};
+  }
+  // A/B 枪各占 8 位：正拒动、正粘连、负拒动、负粘连、解锁、上锁、12V、24V
+  GunStatus gunAt(int shift) const {
+    const std::uint32_t g = flags >> shift;
+    return {(g & 0x02u) != 0, (g & 0x01u) != 0, (g & 0x08u) != 0,
+            (g & 0x04u) != 0, (g & 0x10u) != 0, (g & 0x20u) != 0,
+            (g & 0x40u) != 0, (g & 0x80u) != 0};
+  }
+
+  const CcuRecordMeta &metaOrEmpty() const {
+    static const CcuRecordMeta kEmpty;
+    return meta ? *meta : kEmpty;
+  }
 };
 
 constexpr std::string_view kDeviceTypePILE = "PILE";
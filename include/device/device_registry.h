@@ -0,0 +1,55 @@
+#pragma once
+
+#include "device/device_object.h"
+#include <absl/container/flat_hash_map.h>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace device {
+
+// 每台设备预先拼好的标识与 Redis key，热路径直接引用，不再逐次拼接
+struct DeviceKeys {
+  DeviceHandle handle = kInvalidDeviceHandle;
+  std::string equip_no;
+  // 在线状态：objects:STA#{station_no}:PILE#{equip_order}
+  std::string online_key;
+  // 自检结果模块：selfcheck:{type}#{equip_no}:CCU#*
+  std::string selfcheck_pattern;
+};
+
+// 设备注册表：equip_no <-> DeviceHandle
+// - 按 string_view 异构查找，查找时不构造 std::string
+// - 读多写少（设备加载/同步时写入），读写锁保护
+// - 句柄不回收：设备删除后再加入沿用原句柄（keys 按新属性刷新），
+//   句柄总数以运行期间出现过的设备数为上限
+class DeviceRegistry {
+public:
+  static DeviceRegistry &Instance();
+
+  // 返回设备句柄，首次出现时分配；属性变化时刷新缓存的 key
+  DeviceHandle intern(const PileAttr &attrs);
+
+  // 未注册返回 kInvalidDeviceHandle
+  DeviceHandle find(std::string_view equip_no) const;
+
+  // 句柄无效返回 nullptr；返回的对象不可变，可在锁外长期持有
+  std::shared_ptr<const DeviceKeys> keys(DeviceHandle handle) const;
+
+  std::size_t size() const;
+
+private:
+  DeviceRegistry() = default;
+
+  static std::shared_ptr<const DeviceKeys> MakeKeys(DeviceHandle handle,
+                                                    const PileAttr &attrs);
+
+  mutable std::shared_mutex mutex_;
+  absl::flat_hash_map<std::string, DeviceHandle> by_equip_no_;
+  std::vector<std::shared_ptr<const DeviceKeys>> keys_; // 下标为句柄
+};
+
+} // namespace device
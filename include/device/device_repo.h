@@ -2,35 +2,191 @@
 
 #include "absl/status/statusor.h"
 #include "db/db_row.h"
+#include "device/ccu_detail_cache.h"
 #include "device/pile_device.h"
 #include "model/history_model.h"
 #include "model/pile_model.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace device {
 
+// 每台设备最新一次自检的摘要（只取摘要字段，不返回 DetailsJSON）
+struct LatestCheckSummary {
+  std::string equip_no;
+  std::string record_id;
+  std::string status;     // OK / WARN / ERROR
+  std::string created_at; // yyyy-MM-dd HH:mm:ss
+  int ccu_count = 0;
+  int fail_count = 0; // 存在任一故障的 CCU 数（FaultCcuCount 列）
+};
+
+// 历史记录分页游标：上一页最后一条记录的 (CreatedAt, ID)
+struct HistoryCursor {
+  std::string created_at; // yyyy-MM-dd HH:mm:ss
+  int64_t id = 0;
+};
+
+// 历史记录检索条件，编译为单条参数化 SQL（见 DeviceRepo::SearchHistory）
+// 各列表为空表示不限；时间为 yyyy-MM-dd HH:mm:ss，区间左闭右开
+struct HistoryFilter {
+  std::vector<std::string> equip_nos;
+  std::vector<std::string> statuses;         // OK / WARN / ERROR
+  std::vector<std::string> check_categories; // FULL / QUICK / STARTUP / REMOTE
+  std::vector<std::string> trigger_sources;  // LOCAL / WEB / CLOUD / AUTO
+  std::optional<std::string> from;           // CreatedAt >= from
+  std::optional<std::string> to;             // CreatedAt < to
+  std::string summary_text;                  // Summary 包含该文本
+  int limit = 20;                            // 单页条数，上限 kMaxHistoryLimit
+  std::optional<HistoryCursor> before;       // keyset 分页游标
+};
+
+// equipment_info 中单台设备行内容的 CRC32（见 DeviceRepo::GetPipeDeviceChecksums）
+struct DeviceRowChecksum {
+  std::string equip_no;
+  uint32_t crc = 0;
+};
+
+// 整表校验：行数 + 各行 CRC32 的异或，任一行增删改都会改变其值
+struct DeviceTableChecksum {
+  int64_t row_count = 0;
+  uint64_t crc = 0;
+
+  bool operator==(const DeviceTableChecksum &other) const {
+    return row_count == other.row_count && crc == other.crc;
+  }
+  bool operator!=(const DeviceTableChecksum &other) const {
+    return !(*this == other);
+  }
+};
+
+// 自检结果日汇总（self_check_daily_rollup），按设备/站点/全部设备聚合
+struct DailyRollup {
+  std::string day; // yyyy-MM-dd
+  int total_count = 0;
+  int ok_count = 0;
+  int warn_count = 0;
+  int error_count = 0;
+  int fault_ccu_count = 0;
+  int ac_contactor_faults = 0;
+  int parallel_contactor_faults = 0;
+  int fan_faults = 0;
+  int gun_faults = 0;
+  uint32_t fault_mask = 0; // 当日出现过的故障位
+};
+
 class DeviceRepo {
 public:
+  static constexpr int kMaxHistoryLimit = 500;
+
   static absl::StatusOr<std::vector<PileAttr>> GetAllPipeDevices();
 
+  // 按设备编号批量获取（增量同步时只取变化的行）
+  static absl::StatusOr<std::vector<PileAttr>>
+  GetPipeDevicesByEquipNos(const std::vector<std::string> &equipNos);
+
+  /**
+   * @brief equipment_info 的内容校验和，用于增量同步
+   *
+   * 表中没有更新时间列，改用服务端计算的行 CRC32：
+   * 先比较整表校验（单行结果），不同时再取逐行校验定位变化的设备。
+   */
+  static absl::StatusOr<DeviceTableChecksum> GetPipeDeviceTableChecksum();
+  static absl::StatusOr<std::vector<DeviceRowChecksum>>
+  GetPipeDeviceChecksums();
+
+  /**
+   * @brief 按时间倒序分页获取设备的历史记录
+   *
+   * 采用 keyset 分页：传入上一页最后一条的游标，取 (CreatedAt, ID)
+   * 严格小于游标的下一页，走 idx_equip_ctime_id，无 OFFSET 扫描。
+   * @param before 为空时取第一页
+   */
   static absl::StatusOr<std::vector<qml_model::HistoryItem>>
-  GetHistoryItems(const QString &deviceId, int limit = 10);
+  GetHistoryItems(const QString &deviceId, int limit = 10,
+                  const std::optional<HistoryCursor> &before = std::nullopt);
 
+  /**
+   * @brief 按条件检索历史记录，过滤全部在 SQL 中完成
+   *
+   * 设备列表 + 时间窗走 idx_equip_ctime_id，仅按状态过滤时走
+   * idx_status_ctime；其余条件为回表后的附加过滤。
+   * 摘要文本使用 LIKE '%text%'，通配符已转义，无法走索引，应与其它条件组合使用。
+   */
+  static absl::StatusOr<std::vector<qml_model::HistoryItem>>
+  SearchHistory(const HistoryFilter &filter);
+
+  /**
+   * @brief 获取某条检查记录解码后的 CCU 详情
+   *
+   * 记录写入后不再修改，解码结果按 recordId 缓存在 CcuDetailCache 中。
+   */
   static absl::StatusOr<std::vector<device::CCUAttributes>>
   GetPileItems(const QString &recordId);
 
+  // 同上，直接返回缓存中的共享只读数据，不拷贝
+  static absl::StatusOr<CcuDetailsPtr> GetPileDetails(int64_t recordId);
+
   /**
    * @brief 通过设备ID获取最新的检查记录详情
    *
-   * 先查询该设备最新的检查记录ID，然后获取其详细的 CCU 模块数据。
+   * 先查询该设备最新的检查记录ID（已缓存则跳过），然后获取其详细的 CCU 模块数据。
    * @param deviceId 设备的唯一标识符 (EquipNo)
    * @return 最新检查记录的 CCU 属性列表，若无记录则返回空列表
    */
   static absl::StatusOr<std::vector<device::CCUAttributes>>
   GetLatestPileItems(const QString &deviceId);
 
+  // 同上，返回缓存中的共享只读数据（无记录时为空列表）
+  static absl::StatusOr<CcuDetailsPtr>
+  GetLatestPileDetails(const std::string &equipNo);
+
+  // 只查缓存、不访问数据库：最新记录 ID 与其详情都已缓存时返回，否则 nullptr
+  // 可在 UI 线程调用，用于详情页的同步快速路径
+  static CcuDetailsPtr PeekLatestPileDetails(const std::string &equipNo);
+
+  // 最新记录详情是否已缓存（不计入缓存命中统计）
+  static bool IsLatestCached(const std::string &equipNo);
+
+  // 设备写入新记录后调用，使缓存的“最新记录 ID”失效
+  static void InvalidateLatest(const std::string &equipNo);
+
+  /**
+   * @brief 一次查询取回所有设备最新一条检查记录的摘要
+   *
+   * 用于启动时批量刷新设备卡片，替代逐台调用 GetLatestPileItems。
+   * CCU 数与故障 CCU 数读自摘要列，客户端不解析 DetailsJSON。
+   * 先只查近一个月；equipNos 中窗口内没有记录的设备再回查更早的数据。
+   */
+  static absl::StatusOr<std::vector<LatestCheckSummary>>
+  GetLatestCheckSummaries(const std::unordered_set<std::string> &equipNos);
+
+  /**
+   * @brief 日汇总趋势查询（闭区间 [fromDay, toDay]，日期格式 yyyy-MM-dd）
+   *
+   * 读 self_check_daily_rollup，每台设备每天一行，按日期升序返回。
+   * 站点维度通过 equipment_info.StationNo 关联后按日聚合。
+   */
+  static absl::StatusOr<std::vector<DailyRollup>>
+  GetDeviceDailyRollups(const std::string &equipNo, const std::string &fromDay,
+                        const std::string &toDay);
+
+  static absl::StatusOr<std::vector<DailyRollup>>
+  GetStationDailyRollups(const std::string &stationNo,
+                         const std::string &fromDay, const std::string &toDay);
+
+  static absl::StatusOr<std::vector<DailyRollup>>
+  GetFleetDailyRollups(const std::string &fromDay, const std::string &toDay);
+
 private:
   static PileAttr PileDeviceFromDbRow(const db::DbRow &row);
+
+  static absl::StatusOr<std::vector<device::CCUAttributes>>
+  DecodeDetailsJson(const std::string &detail_json_str,
+                    const std::string &create_at);
 };
 
 } // namespace device
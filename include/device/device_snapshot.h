@@ -0,0 +1,47 @@
+#pragma once
+
+#include "device/device_object.h"
+#include <absl/status/statusor.h>
+
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+namespace device {
+
+class PileDevice;
+
+// 快照中的一台设备：基础属性 + 最后自检摘要 + 最后已知在线状态
+// 不保存 SecretKey / SecretIV，重新从数据库加载后补齐
+struct DeviceSnapshotEntry {
+  PileAttr attrs;
+  SelfCheckResult last_check; // 仅 status / 计数 / last_check_time_str 有效
+  OnlineState online_state = OnlineState::Unknown;
+};
+
+// 本地设备快照，用于启动时立即填充首页，之后由数据库结果在后台校正
+//
+// 文件格式（小端，版本化，可直接 mmap 读取）：
+//   Header  | Record[entry_count] | 字符串区
+// Record 为定长 POD，字符串以 (offset, size) 引用字符串区，读取时无需逐字段解析
+class DeviceSnapshot {
+public:
+  static constexpr std::uint32_t kVersion = 1;
+
+  // ~/ECheckAuto/cache/device_snapshot.bin
+  static QString DefaultPath();
+
+  // 文件不存在返回 NotFound；格式/版本/校验不符返回 DataLoss
+  static absl::StatusOr<std::vector<DeviceSnapshotEntry>>
+  Load(const QString &path);
+
+  // 先写临时文件再原子替换，写入中途崩溃不会破坏旧快照
+  static absl::Status Save(const QString &path,
+                           const std::vector<DeviceSnapshotEntry> &entries);
+
+  static std::vector<DeviceSnapshotEntry>
+  Capture(const std::vector<std::shared_ptr<const PileDevice>> &devices);
+};
+
+} // namespace device
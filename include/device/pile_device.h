@@ -10,10 +10,12 @@ namespace device {
 // ==== 充电箱设备实例 ====
 class PileDevice {
 public:
-  explicit PileDevice(const PileAttr &attrs);
+  explicit PileDevice(const PileAttr &attrs,
+                      DeviceHandle handle = kInvalidDeviceHandle);
   ~PileDevice() = default;
 
   const std::string &Id() const noexcept { return attrs_.equip_no; }
+  DeviceHandle Handle() const noexcept { return handle_; }
   const PileAttr &Attributes() const noexcept { return attrs_; }
   const DeviceStatus &Status() const noexcept { return status_; }
   const SelfCheckResult &LastSelfCheck() const noexcept {
@@ -27,6 +29,8 @@ public:
     return last_check_time_str_;
   }
 
+  // 仅替换基础属性（数据库重新加载时），保留在线状态与自检结果
+  void UpdateAttributes(const PileAttr &attrs) { attrs_ = attrs; }
   void UpdateStatus(const DeviceStatus &status) { status_ = status; }
   void UpdateSelfCheck(const SelfCheckResult &result);
   void UpdateSelfCheckProgress(const std::string &desc, bool is_checking);
@@ -39,6 +43,7 @@ public:
   }
 
 private:
+  DeviceHandle handle_ = kInvalidDeviceHandle;
   PileAttr attrs_;
   DeviceStatus status_{};               // 默认 Unknown/Offline 等
   SelfCheckResult last_self_check_{};   // 默认空结果
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QMetaType>
+#include <QString>
+#include <bit>
+#include <cstdint>
+
+#include "device/device_object.h"
+
+namespace qml_model {
+
+// 一个 CCU 的完整检测结果，作为值类型整体交给 QML
+// （PileModel 的 ccu 角色），一次 data() 调用即可取到全部状态位
+class CcuValue {
+  Q_GADGET
+  Q_PROPERTY(int index MEMBER index_)
+  Q_PROPERTY(quint32 flags MEMBER flags_)
+  Q_PROPERTY(quint32 faultMask READ faultMask)
+  Q_PROPERTY(int faultCount READ faultCount)
+
+public:
+  CcuValue() = default;
+  explicit CcuValue(const device::CCUAttributes &attrs)
+      : index_(attrs.index), flags_(attrs.flags) {}
+
+  quint32 faultMask() const { return flags_ & device::ccu_flag::kAllFaults; }
+  int faultCount() const { return std::popcount(faultMask()); }
+
+  // bit 为 kCcuFields 的 redis_index（见 PileModel.flagBits）
+  Q_INVOKABLE bool test(int bit) const {
+    return bit >= 0 && bit < 32 && ((flags_ >> bit) & 1u) != 0;
+  }
+  // 分组中是否有任一位被置位，mask 见 PileModel 的分组掩码常量
+  Q_INVOKABLE bool any(quint32 mask) const { return (flags_ & mask) != 0; }
+
+private:
+  int index_ = 0;
+  quint32 flags_ = 0;
+};
+
+} // namespace qml_model
+
+Q_DECLARE_METATYPE(qml_model::CcuValue)
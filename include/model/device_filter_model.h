@@ -0,0 +1,150 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QString>
+#include <QStringList>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "device/pile_device.h"
+#include "utils/prefix_trie.h"
+
+namespace qml_model {
+
+class DeviceModel;
+
+// 首页设备列表的过滤/排序/搜索代理
+// - 所有设备按当前排序键维护一份有序索引 order_，过滤结果 visible_ 是它的子序列
+// - 文本搜索走前缀树（名称、英文名、设备编号，按词切分），不逐行匹配字符串
+// - 源模型 dataChanged / 插入 / 删除时只调整受影响的那一行（移动、插入或删除），
+//   不重新排序；只有过滤条件或排序键变化时才线性重建一次
+// - 过滤条件变化时新旧 visible_ 都是 order_ 的子序列，归并比较后只发出增删的
+//   行区间；排序变化发 layoutChanged 并迁移持久索引。视图不会整体重建代理
+class DeviceFilterModel : public QAbstractListModel {
+  Q_OBJECT
+
+  Q_PROPERTY(QString searchText READ searchText WRITE setSearchText NOTIFY
+                 filterChanged)
+  Q_PROPERTY(
+      QString stationNo READ stationNo WRITE setStationNo NOTIFY filterChanged)
+  Q_PROPERTY(
+      bool offlineOnly READ offlineOnly WRITE setOfflineOnly NOTIFY filterChanged)
+  Q_PROPERTY(
+      bool failedOnly READ failedOnly WRITE setFailedOnly NOTIFY filterChanged)
+  Q_PROPERTY(SortKey sortKey READ sortKey WRITE setSortKey NOTIFY sortChanged)
+  Q_PROPERTY(bool sortDescending READ sortDescending WRITE setSortDescending
+                 NOTIFY sortChanged)
+  Q_PROPERTY(int count READ count NOTIFY countChanged)
+  Q_PROPERTY(int totalCount READ totalCount NOTIFY countChanged)
+  Q_PROPERTY(QStringList stations READ stations NOTIFY stationsChanged)
+
+public:
+  enum SortKey {
+    SortByName = 0,   // 名称
+    SortBySeverity,   // 故障严重程度（严重的在前需配合 sortDescending）
+    SortByLastCheck,  // 最后自检时间
+  };
+  Q_ENUM(SortKey)
+
+  explicit DeviceFilterModel(DeviceModel *source, QObject *parent = nullptr);
+
+  // ============ QAbstractListModel 接口（角色与 DeviceModel 一致） ============
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index,
+                int role = Qt::DisplayRole) const override;
+  QHash<int, QByteArray> roleNames() const override;
+
+  QString searchText() const { return search_text_; }
+  void setSearchText(const QString &text);
+  QString stationNo() const { return station_no_; }
+  void setStationNo(const QString &station_no);
+  bool offlineOnly() const { return offline_only_; }
+  void setOfflineOnly(bool value);
+  bool failedOnly() const { return failed_only_; }
+  void setFailedOnly(bool value);
+  SortKey sortKey() const { return sort_key_; }
+  void setSortKey(SortKey key);
+  bool sortDescending() const { return sort_descending_; }
+  void setSortDescending(bool value);
+
+  int count() const { return static_cast<int>(visible_.size()); }
+  int totalCount() const { return static_cast<int>(order_.size()); }
+  // 已出现的站点编号（升序），供站点下拉框使用
+  QStringList stations() const;
+
+  Q_INVOKABLE void clearFilters();
+
+signals:
+  void filterChanged();
+  void sortChanged();
+  void countChanged();
+  void stationsChanged();
+
+private:
+  // 排序/过滤所需的字段，从 PileDevice 提取后缓存，比较时不再访问源模型
+  struct Entry {
+    bool present = false;
+    QString name_key; // 小写名称
+    std::string equip_no;
+    std::string station_no;
+    std::string last_check; // "yyyy-MM-dd HH:mm:ss"，字典序即时间序
+    int severity = 0;
+    bool online = false;
+    bool failed = false;
+    std::vector<std::u16string> search_keys; // 已写入前缀树的 key
+  };
+
+  void onRowsInserted(const QModelIndex &parent, int first, int last);
+  void onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+  void onDataChanged(const QModelIndex &top_left,
+                     const QModelIndex &bottom_right, const QList<int> &roles);
+
+  static Entry MakeEntry(const device::PileDevice &device);
+  // 写入/替换/删除句柄对应的缓存字段，同步前缀树与站点计数；
+  // 返回站点集合是否变化（由调用方决定何时发 stationsChanged）
+  bool storeEntry(device::DeviceHandle handle, Entry &&entry);
+  bool dropEntry(device::DeviceHandle handle);
+
+  bool less(device::DeviceHandle a, device::DeviceHandle b) const;
+  bool accepts(device::DeviceHandle handle) const;
+  bool matchesText(const Entry &entry) const;
+  // 在有序序列中定位 handle（要求序列按当前 entries_ 有序）
+  std::size_t lowerBound(const std::vector<device::DeviceHandle> &seq,
+                         device::DeviceHandle handle) const;
+
+  // 过滤条件变化：重算文本匹配集合，线性扫描 order_ 生成 visible_，
+  // 与旧 visible_ 归并后发出行增删
+  void refilter();
+  // 排序键变化：重排 order_，以 layoutChanged 通知（可见集合不变）
+  void resort();
+  // 源模型重置 / 批量插入：全部重新读取后整体重置
+  void rebuildFromSource();
+  void updateTextMatches();
+  void sortOrder();
+  std::vector<device::DeviceHandle> filterOrder() const;
+  // next 与当前 visible_ 都必须是 order_ 的子序列
+  void mergeVisible(std::vector<device::DeviceHandle> &&next);
+
+  DeviceModel *source_;
+
+  std::vector<Entry> entries_; // 下标为设备句柄
+  std::vector<device::DeviceHandle> order_;   // 全部设备，按排序键有序
+  std::vector<device::DeviceHandle> visible_; // 通过过滤的设备，保持同序
+  utils::PrefixTrie trie_;
+  std::vector<char> text_match_; // 下标为句柄；仅 has_text_filter_ 时有效
+  bool has_text_filter_ = false;
+  std::u16string text_key_; // 小写、去首尾空白后的搜索文本
+  std::string station_key_; // refilter 时由 station_no_ 转换，过滤时不再分配
+  std::map<std::string, int> station_counts_; // 站点 -> 设备数
+
+  QString search_text_;
+  QString station_no_;
+  bool offline_only_ = false;
+  bool failed_only_ = false;
+  SortKey sort_key_ = SortByName;
+  bool sort_descending_ = false;
+};
+
+} // namespace qml_model
@@ -1,11 +1,14 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
+#include "device/device_registry.h"
 #include "device/pile_device.h"
 #include <QAbstractListModel>
 #include <absl/status/status.h>
@@ -32,7 +35,38 @@ public:
     LastCheckTimeRole
   };
 
-  using PileDevicePtr = std::shared_ptr<device::PileDevice>;
+  // 设备状态为不可变快照：更新时复制一份新状态再原子替换，读者无需加锁
+  using PileDevicePtr = std::shared_ptr<const device::PileDevice>;
+
+  // 不可变的设备表（行结构）；插入/删除设备时整体替换并递增版本号。
+  // 每行是一个共享槽位，槽位内的设备状态可被原子替换，因此状态更新
+  // 不需要复制整张表，旧表与新表看到的是同一份最新状态。
+  class DeviceTable {
+  public:
+    int size() const { return static_cast<int>(slots_.size()); }
+    std::uint64_t version() const { return version_; }
+
+    // 行 / 句柄 / 设备编号 -> 当前状态，越界或不存在返回 nullptr
+    PileDevicePtr at(int row) const;
+    PileDevicePtr find(device::DeviceHandle handle) const;
+    PileDevicePtr find(std::string_view equip_no) const;
+    int rowOf(device::DeviceHandle handle) const;
+    int rowOf(std::string_view equip_no) const;
+
+  private:
+    friend class DeviceModel;
+
+    struct Slot {
+      explicit Slot(PileDevicePtr d) : device(std::move(d)) {}
+      std::atomic<PileDevicePtr> device;
+    };
+
+    std::vector<std::shared_ptr<Slot>> slots_;
+    // 设备句柄 -> 行号（-1 表示不在表中），随表一起替换
+    std::vector<int> row_by_handle_;
+    std::uint64_t version_ = 0;
+  };
+  using DeviceTablePtr = std::shared_ptr<const DeviceTable>;
 
   explicit DeviceModel(QObject *parent = nullptr);
   ~DeviceModel() override = default;
@@ -47,33 +81,62 @@ public:
   QHash<int, QByteArray> roleNames() const override;
 
   // ============ 设备增删查 ============
-  // 从属性创建一台设备并接管其生命周期。
+  // 从属性创建一台设备并接管其生命周期；已存在时原地更新属性。
   PileDevicePtr addDevice(const device::PileAttr &attrs);
 
+  // 批量版本（启动加载、快照恢复）：只复制一次设备表，新设备以一次
+  // rowsInserted 通知追加，已存在的设备原地更新属性（相邻行合并为一次
+  // dataChanged）。返回新增的设备数
+  int addDevices(std::vector<device::PileAttr> &&attrs);
+
+  // 移除设备（数据库中已删除的设备），不存在返回 false
+  bool removeDevice(const std::string &equip_no);
+
   // 按业务 ID（equip_no）获取设备，找不到返回 nullptr
   PileDevicePtr getDeviceByEquipNo(const std::string &equip_no) const;
+  PileDevicePtr getDevice(device::DeviceHandle handle) const;
 
   // 是否存在某设备
   bool hasDevice(const std::string &equip_no) const;
 
-  // 返回当前所有设备的快照列表
+  // 当前设备表快照，O(1)，轮询方应优先使用
+  DeviceTablePtr snapshot() const { return table_.load(); }
+
+  // 返回当前所有设备的状态列表（逐行复制，适合低频调用）
   std::vector<PileDevicePtr> allDevices() const;
 
   // ============ 状态更新便捷接口 ============
+  // 热路径（轮询、消息回调）优先使用句柄重载，equip_no 重载先查 DeviceRegistry
+  void updateStatus(device::DeviceHandle handle,
+                    const device::DeviceStatus &status);
+  void updateSelfCheck(device::DeviceHandle handle,
+                       const device::SelfCheckResult &result);
+  void updateSelfCheckProgress(device::DeviceHandle handle,
+                               const std::string &desc, bool is_checking);
+  // 更新单个设备的在线状态
+  void updateOnlineStatus(device::DeviceHandle handle, bool is_online);
+
   void updateStatus(const std::string &equip_no,
                     const device::DeviceStatus &status);
   void updateSelfCheck(const std::string &equip_no,
                        const device::SelfCheckResult &result);
   void updateSelfCheckProgress(const std::string &equip_no,
                                const std::string &desc, bool is_checking);
-
-  // 更新单个设备的在线状态
   void updateOnlineStatus(const std::string &equip_no, bool is_online);
 
 private:
-  mutable std::mutex mutex_;
-  std::vector<PileDevicePtr> device_list_;
-  std::unordered_map<std::string, PileDevicePtr> device_map_; // key: equip_no
+  // 在写锁内复制句柄对应设备的当前状态，交给 fn 修改后原子替换；
+  // fn 返回 false 表示无变化，不替换。返回行号，未找到 / 无变化返回 -1
+  template <typename Fn>
+  int mutateDevice(device::DeviceHandle handle, const char *what, Fn &&fn);
+
+  // 行结构变更（仅 UI 线程）：基于当前表构造新表
+  std::shared_ptr<DeviceTable> cloneTable() const;
+
+  // 读者（data / rowCount / 轮询线程）只原子加载 table_，不加锁
+  std::atomic<DeviceTablePtr> table_;
+  // 仅在写者之间互斥，保证“读取-复制-替换”不丢更新
+  std::mutex write_mutex_;
 };
 
 } // namespace qml_model
@@ -1,10 +1,20 @@
 // SelfCheckHistoryModel.h
 #pragma once
 
-#include <QAbstractListModel>
 #include <QDateTime>
+#include <QVariantMap>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <vector>
 
+#include "model/keyed_list_model.h"
+
+namespace device {
+struct HistoryCursor;
+struct HistoryFilter;
+} // namespace device
+
 namespace qml_model {
 struct HistoryItem {
   QString recordId;    // MySQL 主键 ID（推荐）
@@ -12,12 +22,22 @@ struct HistoryItem {
   QDateTime timestamp; // 自检时间
   QString status;      // "normal" / "warning" / "error"
   QString summary;     // 简要描述，比如 "正常: 5, 异常: 1"
+
+  // 故障摘要列（见 device::FaultSummary），直接来自表列
+  int ccuCount = 0;
+  int faultCcuCount = 0;
+  int acContactorFaults = 0;
+  int parallelContactorFaults = 0;
+  int fanFaults = 0;
+  int gunFaults = 0;
+  quint32 faultMask = 0;
 };
 
-class HistoryModel : public QAbstractListModel {
+class HistoryModel : public KeyedListModel {
   Q_OBJECT
 
   Q_PROPERTY(bool loading READ loading NOTIFY loadingChanged)
+  Q_PROPERTY(bool hasMore READ hasMore NOTIFY hasMoreChanged)
   Q_PROPERTY(QString lastError READ lastError NOTIFY errorChanged)
 
 public:
@@ -27,10 +47,20 @@ public:
     TimestampRole,
     TimestampDisplayRole,
     StatusRole,
-    SummaryRole
+    SummaryRole,
+    CcuCountRole,
+    FaultCcuCountRole,
+    AcContactorFaultsRole,
+    ParallelContactorFaultsRole,
+    FanFaultsRole,
+    GunFaultsRole,
+    FaultMaskRole
   };
   Q_ENUM(Roles)
 
+  // 实时推送累积的行数上限
+  static constexpr int kMaxLiveItems = 500;
+
   explicit HistoryModel(QObject *parent = nullptr);
 
   // QAbstractListModel 必备
@@ -38,11 +68,27 @@ public:
   QVariant data(const QModelIndex &index, int role) const override;
   QHash<int, QByteArray> roleNames() const override;
 
+  // 增量加载：滚动到底部时由视图调用，按 keyset 游标取下一页
+  bool canFetchMore(const QModelIndex &parent) const override;
+  void fetchMore(const QModelIndex &parent) override;
+
   // 给 QML 用的懒加载接口
+  // 加载第一页（limit 同时作为后续分页大小）；新的请求会取代仍在进行中的旧请求
   Q_INVOKABLE void load(const QString &deviceId, int limit = 10);
+  // 按条件检索（服务端过滤），支持的键：
+  //   deviceIds / statuses / categories / triggerSources: 字符串数组
+  //   from / to: 日期时间（Date 或 "yyyy-MM-dd[ HH:mm:ss]"），左闭右开
+  //   text: 摘要包含的文本；limit: 每页条数
+  Q_INVOKABLE void search(const QVariantMap &filter);
+  Q_INVOKABLE void loadMore() { fetchMore(QModelIndex()); }
   Q_INVOKABLE QVariant get(int row) const;
   bool loading() const { return loading_; }
+  bool hasMore() const { return has_more_; }
   QString lastError() const { return last_error_; }
+  // 新落库的自检记录：符合当前检索条件时插到首行（单次行插入），
+  // 超过 kMaxLiveItems 时裁掉末尾，之后可继续按游标分页
+  void prependRecord(const HistoryItem &item, const QString &checkCategory,
+                     const QString &triggerSource);
   Q_INVOKABLE QString GetFirstItemRecordId() const {
     if (items_.empty())
       return {};
@@ -51,15 +97,33 @@ public:
 
 signals:
   void loadingChanged();
+  void hasMoreChanged();
   void errorChanged(const QString &message);
 
 private:
   std::vector<HistoryItem> items_;
   bool loading_{false};
+  bool has_more_{false};
   QString last_error_;
 
+  // 当前检索条件（分页时复用），不可变，按值捕获到后台任务
+  std::shared_ptr<const device::HistoryFilter> filter_;
+  // 每次 load 自增；返回结果的代数不匹配即为过期请求，直接丢弃
+  std::uint64_t generation_{0};
+
+  void applyFilter(std::shared_ptr<const device::HistoryFilter> filter,
+                   bool keep_items);
+  void requestPage(const std::optional<device::HistoryCursor> &cursor);
   void setLoading(bool v);
+  void setHasMore(bool v);
   void setLastError(const QString &message);
+  // 按 recordId 与当前列表做差异更新
   void setItems(std::vector<HistoryItem> &&items);
+  static QList<int> ChangedRoles(const HistoryItem &before,
+                                 const HistoryItem &after);
+  static bool Accepts(const device::HistoryFilter &filter,
+                      const HistoryItem &item, const QString &checkCategory,
+                      const QString &triggerSource);
+  void appendItems(std::vector<HistoryItem> &&items);
 };
 } // namespace qml_model
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QSet>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace qml_model {
+
+// 以 key 对齐新旧列表、只通知差异的列表模型基类
+// 刷新同一份数据时不再 reset：视图保留代理与滚动位置，只重绘真正变化的行
+class KeyedListModel : public QAbstractListModel {
+  Q_OBJECT
+
+public:
+  using QAbstractListModel::QAbstractListModel;
+
+protected:
+  /**
+   * @brief 用 next 替换 items，并发出最小的行级变化通知
+   *
+   * - 新列表中不存在的行：rowsRemoved（连续区间合并）
+   * - 旧列表中不存在的行：rowsInserted（连续区间合并）
+   * - 位置变化的行：rowsMoved
+   * - 同 key 的行：changed_roles(old, new) 非空时替换并发出 dataChanged(roles)
+   * 任一列表内 key 重复时退化为 reset。
+   * @param key           const T & -> 可放入 QSet 的 key
+   * @param changed_roles (const T &old, const T &new) -> QList<int>
+   */
+  template <typename T, typename KeyFn, typename RolesFn>
+  void applyKeyedDiff(std::vector<T> &items, std::vector<T> &&next, KeyFn key,
+                      RolesFn changed_roles) {
+    using Key = std::decay_t<std::invoke_result_t<KeyFn, const T &>>;
+
+    QSet<Key> next_keys;
+    next_keys.reserve(static_cast<qsizetype>(next.size()));
+    for (const auto &item : next) {
+      next_keys.insert(key(item));
+    }
+    QSet<Key> old_keys;
+    old_keys.reserve(static_cast<qsizetype>(items.size()));
+    for (const auto &item : items) {
+      old_keys.insert(key(item));
+    }
+    if (next_keys.size() != static_cast<qsizetype>(next.size()) ||
+        old_keys.size() != static_cast<qsizetype>(items.size())) {
+      beginResetModel();
+      items = std::move(next);
+      endResetModel();
+      return;
+    }
+
+    // 1. 删除新列表中已不存在的行（自后向前，合并连续区间）
+    for (int row = static_cast<int>(items.size()) - 1; row >= 0;) {
+      if (next_keys.contains(key(items[row]))) {
+        --row;
+        continue;
+      }
+      int first = row;
+      while (first > 0 && !next_keys.contains(key(items[first - 1]))) {
+        --first;
+      }
+      beginRemoveRows(QModelIndex(), first, row);
+      items.erase(items.begin() + first, items.begin() + row + 1);
+      endRemoveRows();
+      row = first - 1;
+    }
+
+    // 2. 按新顺序逐位对齐：新 key 插入，错位的行移上来，同位的行比较字段
+    const int count = static_cast<int>(next.size());
+    for (int row = 0; row < count;) {
+      const Key k = key(next[row]);
+      if (!old_keys.contains(k)) {
+        int last = row;
+        while (last + 1 < count && !old_keys.contains(key(next[last + 1]))) {
+          ++last;
+        }
+        beginInsertRows(QModelIndex(), row, last);
+        items.insert(items.begin() + row,
+                     std::make_move_iterator(next.begin() + row),
+                     std::make_move_iterator(next.begin() + last + 1));
+        endInsertRows();
+        row = last + 1;
+        continue;
+      }
+
+      if (key(items[row]) != k) {
+        // 其余旧行都在新列表中，k 一定在 row 之后
+        int from = row + 1;
+        while (key(items[from]) != k) {
+          ++from;
+        }
+        beginMoveRows(QModelIndex(), from, from, QModelIndex(), row);
+        std::rotate(items.begin() + row, items.begin() + from,
+                    items.begin() + from + 1);
+        endMoveRows();
+      }
+
+      const QList<int> roles = changed_roles(items[row], next[row]);
+      if (!roles.isEmpty()) {
+        items[row] = std::move(next[row]);
+        const QModelIndex idx = index(row);
+        emit dataChanged(idx, idx, roles);
+      }
+      ++row;
+    }
+  }
+};
+
+} // namespace qml_model
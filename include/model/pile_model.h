@@ -1,14 +1,15 @@
 #pragma once
 
 #include "device/device_object.h"
-#include <QAbstractListModel>
+#include "model/keyed_list_model.h"
 #include <QString>
+#include <QVariantMap>
 #include <qtmetamacros.h>
 #include <vector>
 
 namespace qml_model {
 
-class PileModel : public QAbstractListModel {
+class PileModel : public KeyedListModel {
   Q_OBJECT
   Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
   Q_PROPERTY(bool loading READ loading NOTIFY loadingChanged)
@@ -16,6 +17,10 @@ class PileModel : public QAbstractListModel {
   Q_PROPERTY(QString deviceName READ deviceName NOTIFY countChanged)
   Q_PROPERTY(QString deviceId READ deviceId NOTIFY countChanged)
   Q_PROPERTY(QString deviceType READ deviceType NOTIFY countChanged)
+  // 状态位名 -> 位号（kCcuFields 的 redis_index），QML 按位解码 flags 时使用
+  Q_PROPERTY(QVariantMap flagBits READ flagBits CONSTANT)
+  // 计入故障的字段数
+  Q_PROPERTY(int faultFieldCount READ faultFieldCount CONSTANT)
 
 public:
   enum Roles {
@@ -24,38 +29,17 @@ public:
     DeviceNameRole,
     DeviceTypeRole,
     LastCheckTimeRole,
-    Ac1StuckRole,
-    Ac1RefuseRole,
-    Ac2StuckRole,
-    Ac2RefuseRole,
-    ParPosStuckRole,
-    ParPosRefuseRole,
-    ParNegStuckRole,
-    ParNegRefuseRole,
-    Fan1StoppedRole,
-    Fan1RotatingRole,
-    Fan2StoppedRole,
-    Fan2RotatingRole,
-    Fan3StoppedRole,
-    Fan3RotatingRole,
-    Fan4StoppedRole,
-    Fan4RotatingRole,
-    GunAPosStuckRole,
-    GunAPosRefuseRole,
-    GunANegStuckRole,
-    GunANegRefuseRole,
-    GunAUnlockedRole,
-    GunALockedRole,
-    GunAAux12Role,
-    GunAAux24Role,
-    GunBPosStuckRole,
-    GunBPosRefuseRole,
-    GunBNegStuckRole,
-    GunBNegRefuseRole,
-    GunBUnlockedRole,
-    GunBLockedRole,
-    GunBAux12Role,
-    GunBAux24Role
+    // 紧凑角色：每个代理只需读取少量值，状态位在 QML 中按位解码
+    FlagsRole,                  // 全部 32 个状态位
+    AcContactorFlagsRole,       // 各分组的状态位（flags & 分组掩码，位号不变）
+    ParallelContactorFlagsRole,
+    FanFlagsRole,
+    GunFlagsRole,
+    FaultMaskRole,              // 故障位
+    FaultCountRole,             // 故障位个数
+    CcuRole,                    // CcuValue，整个 CCU 的值类型
+    // 逐位 role（兼容旧绑定）：FirstFlagRole + redis_index，名称取自 kCcuFields
+    FirstFlagRole
   };
   Q_ENUM(Roles)
 
@@ -81,16 +65,18 @@ public:
   // 便捷属性：从第一项获取设备信息
   QString deviceName() const {
     return items_.empty() ? QString()
-                          : QString::fromStdString(items_[0].device_name);
+                          : QString::fromStdString(items_[0].device_name());
   }
   QString deviceId() const {
     return items_.empty() ? QString()
-                          : QString::fromStdString(items_[0].device_id);
+                          : QString::fromStdString(items_[0].device_id());
   }
   QString deviceType() const {
     return items_.empty() ? QString()
-                          : QString::fromStdString(items_[0].device_type);
+                          : QString::fromStdString(items_[0].device_type());
   }
+  static QVariantMap flagBits();
+  static int faultFieldCount();
 
 signals:
   void countChanged();
@@ -102,7 +88,11 @@ private:
   bool loading_{false};
   QString last_error_;
 
-  void resetWith(std::vector<device::CCUAttributes> &&items);
+  // 按 CCU 序号与当前列表做差异更新（刷新同一设备时不重建代理）
+  void applyItems(std::vector<device::CCUAttributes> &&items);
+  // 同一 CCU 新旧两次结果之间变化的 role
+  static QList<int> ChangedRoles(const device::CCUAttributes &before,
+                                 const device::CCUAttributes &after);
   void setLoading(bool loading);
   void setLastError(const QString &error);
   void loadAsyncByRecordId(const QString &recordId);
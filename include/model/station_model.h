@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QAbstractItemModel>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "device/pile_device.h"
+
+namespace qml_model {
+
+class DeviceModel;
+
+// 按站点分组的设备树：顶层为站点，子节点为该站点的设备
+// - 站点节点带在线/离线/自检中/自检失败计数，随设备变化增量加减，
+//   读取站点行不遍历子节点
+// - 设备行的数据直接转发 DeviceModel 的角色；视图（TreeView）只为展开的
+//   站点创建子节点代理，收起的站点没有渲染开销
+class StationModel : public QAbstractItemModel {
+  Q_OBJECT
+
+  Q_PROPERTY(int stationCount READ stationCount NOTIFY stationCountChanged)
+
+public:
+  // 站点行角色，起始值避开 DeviceModel 的设备角色
+  enum StationRoles {
+    IsStationRole = Qt::UserRole + 100,
+    StationNoRole,
+    DeviceCountRole,
+    OnlineCountRole,
+    OfflineCountRole,
+    CheckingCountRole,
+    FailedCountRole
+  };
+
+  explicit StationModel(DeviceModel *source, QObject *parent = nullptr);
+  ~StationModel() override;
+
+  // ============ QAbstractItemModel 接口 ============
+  QModelIndex index(int row, int column,
+                    const QModelIndex &parent = QModelIndex()) const override;
+  QModelIndex parent(const QModelIndex &child) const override;
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index,
+                int role = Qt::DisplayRole) const override;
+  QHash<int, QByteArray> roleNames() const override;
+
+  int stationCount() const { return static_cast<int>(rows_.size()); }
+
+signals:
+  void stationCountChanged();
+
+private:
+  struct Counters {
+    int total = 0;
+    int online = 0;
+    int checking = 0;
+    int failed = 0;
+
+    bool operator==(const Counters &) const = default;
+  };
+
+  struct StationNode {
+    std::string station_no;
+    int row = 0; // 在 rows_ 中的位置，站点增删时刷新
+    std::vector<device::DeviceHandle> devices;
+    Counters counters;
+  };
+
+  // 设备句柄 -> 所在站点及计入计数的状态
+  struct Member {
+    StationNode *station = nullptr;
+    int child_row = 0;
+    bool online = false;
+    bool checking = false;
+    bool failed = false;
+  };
+
+  void onRowsInserted(const QModelIndex &parent, int first, int last);
+  void onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+  void onDataChanged(const QModelIndex &top_left,
+                     const QModelIndex &bottom_right, const QList<int> &roles);
+  void rebuildFromSource();
+
+  // 加入 / 移出站点（负责站点节点的创建与删除以及计数）
+  void attach(const device::PileDevice &device);
+  void detach(device::DeviceHandle handle);
+
+  StationNode *findStation(const std::string &station_no) const;
+  // emplaceStation 不发信号（重置时用），insertStation 发行插入信号
+  StationNode *emplaceStation(const std::string &station_no);
+  StationNode *insertStation(const std::string &station_no);
+  void removeStation(StationNode *station);
+
+  static void Count(Counters &counters, const Member &member, int sign);
+  QModelIndex stationIndex(const StationNode *station) const;
+  Member *member(device::DeviceHandle handle);
+
+  DeviceModel *source_;
+  std::vector<std::unique_ptr<StationNode>> rows_; // 按 station_no 升序
+  std::vector<Member> members_;                    // 下标为设备句柄
+};
+
+} // namespace qml_model
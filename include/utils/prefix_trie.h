@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace utils {
+
+// 前缀索引：key 为 UTF-16 文本（直接取自 QString，调用方先转小写），值为 id
+// - 每个节点保存子树内全部 id，查询只需沿前缀走到节点，结果直接可用
+// - 同一 id 可挂多个 key（名称、英文名、设备编号……），查询结果可能重复
+// - 删除只摘掉 id，不回收节点；整体重建时调用 clear()
+class PrefixTrie {
+public:
+  using Id = std::uint32_t;
+
+  PrefixTrie() { clear(); }
+
+  void insert(std::u16string_view key, Id id);
+  void erase(std::u16string_view key, Id id);
+
+  // 以 prefix 开头的所有 key 的 id；空前缀返回 nullptr（调用方视为不过滤）
+  // 指针在下一次 insert/erase/clear 之前有效
+  const std::vector<Id> *find(std::u16string_view prefix) const;
+
+  void clear();
+
+private:
+  static constexpr std::uint32_t kNoNode = 0xFFFFFFFFu;
+
+  struct Node {
+    // 按字符排序，二分查找；中文名称扇出大，但单节点子节点数仍然很少
+    std::vector<std::pair<char16_t, std::uint32_t>> children;
+    std::vector<Id> ids;
+  };
+
+  std::uint32_t child(std::uint32_t node, char16_t c) const;
+
+  std::vector<Node> nodes_; // nodes_[0] 为根
+};
+
+} // namespace utils
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "device/device_repo.h"
+#include "model/device_model.h"
+#include <QObject>
+#include <QTimer>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace watcher {
+
+// DeviceSyncWatcher: 周期性检查 equipment_info 的变化并增量同步到 DeviceModel
+// - 每轮先取整表校验（一行结果），未变化则结束，代价接近于零
+// - 变化时取逐行 CRC32，与上次结果比较得出新增/修改/删除的设备
+// - 只拉取新增/修改的行，在主线程对 Model 做最小的插入/删除/dataChanged
+class DeviceSyncWatcher : public QObject {
+  Q_OBJECT
+
+  Q_PROPERTY(int syncIntervalMs READ syncIntervalMs WRITE setSyncIntervalMs
+                 NOTIFY syncIntervalMsChanged)
+  Q_PROPERTY(bool running READ isRunning NOTIFY runningChanged)
+
+public:
+  explicit DeviceSyncWatcher(qml_model::DeviceModel *device_model,
+                             QObject *parent = nullptr);
+  ~DeviceSyncWatcher() override;
+
+  DeviceSyncWatcher(const DeviceSyncWatcher &) = delete;
+  DeviceSyncWatcher &operator=(const DeviceSyncWatcher &) = delete;
+
+  // 启动后立即做一次基线同步（记录校验和，并对齐 Model 中的设备集合）
+  Q_INVOKABLE void start();
+  Q_INVOKABLE void stop();
+  Q_INVOKABLE void syncNow();
+
+  int syncIntervalMs() const { return sync_interval_ms_; }
+  void setSyncIntervalMs(int ms);
+
+  bool isRunning() const { return running_.load(); }
+
+signals:
+  void syncIntervalMsChanged();
+  void runningChanged();
+  // 有变化并已应用到 Model 时发出
+  void devicesSynced(int added, int updated, int removed);
+
+private:
+  // 在数据库线程池执行；有变化需要应用时返回 true，
+  // 此时由主线程应用完成后提交基线并结束本轮（释放 in_flight_）
+  bool syncOnce();
+  void commitBaseline(const device::DeviceTableChecksum &table_checksum,
+                      std::unordered_map<std::string, uint32_t> row_checksums);
+
+  qml_model::DeviceModel *device_model_;
+  QTimer *sync_timer_;
+  int sync_interval_ms_ = 60000; // 默认 60 秒
+  std::atomic<bool> running_{false};
+  std::atomic<bool> in_flight_{false}; // 同一时刻只允许一轮同步
+
+  std::mutex mutex_; // 保护以下状态（同步任务读取，应用到 Model 之后才写入）
+  bool has_baseline_ = false;
+  device::DeviceTableChecksum table_checksum_;
+  std::unordered_map<std::string, uint32_t> row_checksums_; // key: equip_no
+};
+
+} // namespace watcher
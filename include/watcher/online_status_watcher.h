@@ -55,7 +55,7 @@ private:
   // 从 Redis 查询单个设备的在线状态（目前仅支持 PILE 类型）
   // Redis Key 格式: objects:STA#{station_no}:PILE#{equip_order}
   // Field: comm，值为 "true" 表示在线
-  static bool queryOnlineStatus(const std::string &station_no, int equip_order);
+  static bool queryOnlineStatus(const std::string &key);
 
   // 批量查询所有设备的在线状态（在子线程执行）
   void pollAllDevices();
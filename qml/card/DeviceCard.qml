@@ -5,6 +5,7 @@ import QtQuick.Controls.Material 2.15
 import QtQuick.Layouts 1.15
 import Qt5Compat.GraphicalEffects
 import GUI
+import EAutoCheck 1.0
 
 Control {
     id: root
@@ -63,6 +64,7 @@ Control {
 
         onPressed: {
             longPressTimer.start()
+            root.prefetchDetail()
         }
 
         onReleased: {
@@ -76,6 +78,20 @@ Control {
         }
     }
 
+    // ========== 详情预取 ==========
+    // 悬停或按下时预热详情数据，长按进入详情页时通常已命中缓存
+    HoverHandler {
+        onHoveredChanged: {
+            if (hovered)
+                root.prefetchDetail()
+        }
+    }
+
+    function prefetchDetail() {
+        if (deviceId.length > 0)
+            DetailPrefetcher.hint(deviceId, DetailPrefetcher.Hovered)
+    }
+
     // 长按进度计时器
     Timer {
         id: longPressTimer
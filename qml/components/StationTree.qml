@@ -0,0 +1,130 @@
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+import GUI
+import EAutoCheck 1.0
+
+// 按站点分组的设备列表（数据来自 C++ StationModel）
+// 站点默认收起；TreeView 只为展开站点下的可见行创建代理
+TreeView {
+  id: root
+
+  signal deviceActivated(string deviceId)
+
+  clip: true
+  model: StationModel
+
+  delegate: Item {
+    id: row
+
+    required property TreeView treeView
+    required property bool isTreeNode
+    required property bool expanded
+    required property bool hasChildren
+    required property int depth
+    required property int row
+    required property var model
+
+    implicitWidth: root.width
+    implicitHeight: model.isStation ? AppLayout.touchButtonHeight
+                                    : AppLayout.buttonHeightMedium
+
+    Rectangle {
+      anchors.fill: parent
+      color: model.isStation ? AppTheme.backgroundSecondary : "transparent"
+      border.color: AppTheme.borderSubtle
+      border.width: model.isStation ? AppLayout.borderWidthThin : 0
+    }
+
+    TapHandler {
+      onTapped: {
+        if (row.model.isStation)
+          row.treeView.toggleExpanded(row.row)
+        else
+          root.deviceActivated(row.model.equipNo)
+      }
+    }
+
+    // 站点行：计数由 C++ 增量维护，这里只读取
+    RowLayout {
+      anchors.fill: parent
+      anchors.leftMargin: AppLayout.marginMedium
+      anchors.rightMargin: AppLayout.marginMedium
+      spacing: AppLayout.spacingMedium
+      visible: row.model.isStation
+
+      Label {
+        text: row.expanded ? "▾" : "▸"
+        font: AppFont.body
+        color: AppTheme.foregroundSecondary
+      }
+      Label {
+        Layout.fillWidth: true
+        text: qsTr("站点 %1").arg(row.model.stationNo)
+        font: AppFont.bodyBold
+        color: AppTheme.foregroundPrimary
+        elide: Text.ElideRight
+      }
+      Label {
+        text: qsTr("共 %1").arg(row.model.deviceCount)
+        font: AppFont.caption
+        color: AppTheme.foregroundSecondary
+      }
+      Label {
+        text: qsTr("在线 %1").arg(row.model.onlineCount)
+        font: AppFont.caption
+        color: AppTheme.success
+      }
+      Label {
+        text: qsTr("离线 %1").arg(row.model.offlineCount)
+        font: AppFont.caption
+        color: row.model.offlineCount > 0 ? AppTheme.error : AppTheme.foregroundSecondary
+      }
+      Label {
+        text: qsTr("自检中 %1").arg(row.model.checkingCount)
+        font: AppFont.caption
+        color: AppTheme.foregroundSecondary
+        visible: row.model.checkingCount > 0
+      }
+      Label {
+        text: qsTr("失败 %1").arg(row.model.failedCount)
+        font: AppFont.caption
+        color: AppTheme.warning
+        visible: row.model.failedCount > 0
+      }
+    }
+
+    // 设备行
+    RowLayout {
+      anchors.fill: parent
+      anchors.leftMargin: AppLayout.marginXLarge + row.depth * AppLayout.marginMedium
+      anchors.rightMargin: AppLayout.marginMedium
+      spacing: AppLayout.spacingMedium
+      visible: !row.model.isStation
+
+      Rectangle {
+        width: 10
+        height: 10
+        radius: 5
+        color: row.model.isOnline ? AppTheme.success : AppTheme.error
+      }
+      Label {
+        Layout.fillWidth: true
+        text: (row.model.name || "") + "  " + (row.model.equipNo || "")
+        font: AppFont.body
+        color: AppTheme.foregroundPrimary
+        elide: Text.ElideRight
+      }
+      Label {
+        text: row.model.statusText || ""
+        font: AppFont.caption
+        color: AppTheme.foregroundSecondary
+      }
+      Label {
+        text: row.model.lastCheckTime || ""
+        font: AppFont.caption
+        color: AppTheme.foregroundSecondary
+      }
+    }
+  }
+}
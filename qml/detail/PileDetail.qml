@@ -125,29 +125,14 @@ Item {
 
                         property bool expanded: true
 
-                        // 粗略统计：异常项
-                        readonly property int totalChecks: 20
-                        readonly property int abnormalCount:
-                            (model.ac1_stuck ? 1 : 0) +
-                            (model.ac1_refuse ? 1 : 0) +
-                            (model.ac2_stuck ? 1 : 0) +
-                            (model.ac2_refuse ? 1 : 0) +
-                            (model.par_pos_stuck ? 1 : 0) +
-                            (model.par_pos_refuse ? 1 : 0) +
-                            (model.par_neg_stuck ? 1 : 0) +
-                            (model.par_neg_refuse ? 1 : 0) +
-                            (model.fan1_stopped ? 1 : 0) +
-                            (model.fan2_stopped ? 1 : 0) +
-                            (model.fan3_stopped ? 1 : 0) +
-                            (model.fan4_stopped ? 1 : 0) +
-                            (model.gunA_pos_stuck ? 1 : 0) +
-                            (model.gunA_pos_refuse ? 1 : 0) +
-                            (model.gunA_neg_stuck ? 1 : 0) +
-                            (model.gunA_neg_refuse ? 1 : 0) +
-                            (model.gunB_pos_stuck ? 1 : 0) +
-                            (model.gunB_pos_refuse ? 1 : 0) +
-                            (model.gunB_neg_stuck ? 1 : 0) +
-                            (model.gunB_neg_refuse ? 1 : 0)
+                        // 每个代理只读取 flags / faultCount 两个角色，各状态位在本地按位解码
+                        readonly property var flags: model.flags
+                        readonly property int totalChecks: PileModel.faultFieldCount
+                        readonly property int abnormalCount: model.faultCount
+
+                        function bit(name) {
+                            return ((flags >>> PileModel.flagBits[name]) & 1) === 1
+                        }
 
                         readonly property int normalCount: totalChecks - abnormalCount
 
@@ -231,13 +216,13 @@ Item {
 
                                         StatusRow {
                                             label: qsTr("粘连")
-                                            valueText: statusText(model.ac1_stuck)
-                                            valueColor: statusColor(model.ac1_stuck)
+                                            valueText: statusText(card.bit("ac1_stuck"))
+                                            valueColor: statusColor(card.bit("ac1_stuck"))
                                         }
                                         StatusRow {
                                             label: qsTr("拒动")
-                                            valueText: statusText(model.ac1_refuse)
-                                            valueColor: statusColor(model.ac1_refuse)
+                                            valueText: statusText(card.bit("ac1_refuse"))
+                                            valueColor: statusColor(card.bit("ac1_refuse"))
                                         }
                                     }
                                 }
@@ -255,13 +240,13 @@ Item {
 
                                         StatusRow {
                                             label: qsTr("粘连")
-                                            valueText: statusText(model.ac2_stuck)
-                                            valueColor: statusColor(model.ac2_stuck)
+                                            valueText: statusText(card.bit("ac2_stuck"))
+                                            valueColor: statusColor(card.bit("ac2_stuck"))
                                         }
                                         StatusRow {
                                             label: qsTr("拒动")
-                                            valueText: statusText(model.ac2_refuse)
-                                            valueColor: statusColor(model.ac2_refuse)
+                                            valueText: statusText(card.bit("ac2_refuse"))
+                                            valueColor: statusColor(card.bit("ac2_refuse"))
                                         }
                                     }
                                 }
@@ -279,23 +264,23 @@ Item {
 
                                         StatusRow {
                                             label: qsTr("正极粘连")
-                                            valueText: statusText(model.par_pos_stuck)
-                                            valueColor: statusColor(model.par_pos_stuck)
+                                            valueText: statusText(card.bit("par_pos_stuck"))
+                                            valueColor: statusColor(card.bit("par_pos_stuck"))
                                         }
                                         StatusRow {
                                             label: qsTr("正极拒动")
-                                            valueText: statusText(model.par_pos_refuse)
-                                            valueColor: statusColor(model.par_pos_refuse)
+                                            valueText: statusText(card.bit("par_pos_refuse"))
+                                            valueColor: statusColor(card.bit("par_pos_refuse"))
                                         }
                                         StatusRow {
                                             label: qsTr("负极粘连")
-                                            valueText: statusText(model.par_neg_stuck)
-                                            valueColor: statusColor(model.par_neg_stuck)
+                                            valueText: statusText(card.bit("par_neg_stuck"))
+                                            valueColor: statusColor(card.bit("par_neg_stuck"))
                                         }
                                         StatusRow {
                                             label: qsTr("负极拒动")
-                                            valueText: statusText(model.par_neg_refuse)
-                                            valueColor: statusColor(model.par_neg_refuse)
+                                            valueText: statusText(card.bit("par_neg_refuse"))
+                                            valueColor: statusColor(card.bit("par_neg_refuse"))
                                         }
                                     }
                                 }
@@ -318,13 +303,13 @@ Item {
 
                                             StatusRow {
                                                 label: qsTr("停转反馈")
-                                                valueText: model.fan1_stopped ? qsTr("是") : qsTr("否")
-                                                valueColor: model.fan1_stopped ? AppTheme.error : AppTheme.success
+                                                valueText: card.bit("fan1_stopped") ? qsTr("是") : qsTr("否")
+                                                valueColor: card.bit("fan1_stopped") ? AppTheme.error : AppTheme.success
                                             }
                                             StatusRow {
                                                 label: qsTr("转动反馈")
-                                                valueText: model.fan1_rotating ? qsTr("是") : qsTr("否")
-                                                valueColor: model.fan1_rotating ? AppTheme.success : AppTheme.muted
+                                                valueText: card.bit("fan1_rotating") ? qsTr("是") : qsTr("否")
+                                                valueColor: card.bit("fan1_rotating") ? AppTheme.success : AppTheme.muted
                                             }
                                         }
 
@@ -337,13 +322,13 @@ Item {
 
                                             StatusRow {
                                                 label: qsTr("停转反馈")
-                                                valueText: model.fan2_stopped ? qsTr("是") : qsTr("否")
-                                                valueColor: model.fan2_stopped ? AppTheme.error : AppTheme.success
+                                                valueText: card.bit("fan2_stopped") ? qsTr("是") : qsTr("否")
+                                                valueColor: card.bit("fan2_stopped") ? AppTheme.error : AppTheme.success
                                             }
                                             StatusRow {
                                                 label: qsTr("转动反馈")
-                                                valueText: model.fan2_rotating ? qsTr("是") : qsTr("否")
-                                                valueColor: model.fan2_rotating ? AppTheme.success : AppTheme.muted
+                                                valueText: card.bit("fan2_rotating") ? qsTr("是") : qsTr("否")
+                                                valueColor: card.bit("fan2_rotating") ? AppTheme.success : AppTheme.muted
                                             }
                                         }
 
@@ -356,13 +341,13 @@ Item {
 
                                             StatusRow {
                                                 label: qsTr("停转反馈")
-                                                valueText: model.fan3_stopped ? qsTr("是") : qsTr("否")
-                                                valueColor: model.fan3_stopped ? AppTheme.error : AppTheme.success
+                                                valueText: card.bit("fan3_stopped") ? qsTr("是") : qsTr("否")
+                                                valueColor: card.bit("fan3_stopped") ? AppTheme.error : AppTheme.success
                                             }
                                             StatusRow {
                                                 label: qsTr("转动反馈")
-                                                valueText: model.fan3_rotating ? qsTr("是") : qsTr("否")
-                                                valueColor: model.fan3_rotating ? AppTheme.success : AppTheme.muted
+                                                valueText: card.bit("fan3_rotating") ? qsTr("是") : qsTr("否")
+                                                valueColor: card.bit("fan3_rotating") ? AppTheme.success : AppTheme.muted
                                             }
                                         }
 
@@ -375,13 +360,13 @@ Item {
 
                                             StatusRow {
                                                 label: qsTr("停转反馈")
-                                                valueText: model.fan4_stopped ? qsTr("是") : qsTr("否")
-                                                valueColor: model.fan4_stopped ? AppTheme.error : AppTheme.success
+                                                valueText: card.bit("fan4_stopped") ? qsTr("是") : qsTr("否")
+                                                valueColor: card.bit("fan4_stopped") ? AppTheme.error : AppTheme.success
                                             }
                                             StatusRow {
                                                 label: qsTr("转动反馈")
-                                                valueText: model.fan4_rotating ? qsTr("是") : qsTr("否")
-                                                valueColor: model.fan4_rotating ? AppTheme.success : AppTheme.muted
+                                                valueText: card.bit("fan4_rotating") ? qsTr("是") : qsTr("否")
+                                                valueColor: card.bit("fan4_rotating") ? AppTheme.success : AppTheme.muted
                                             }
                                         }
                                     }
@@ -400,23 +385,23 @@ Item {
 
                                         StatusRow {
                                             label: qsTr("正极接触器粘连")
-                                            valueText: statusText(model.gunA_pos_stuck)
-                                            valueColor: statusColor(model.gunA_pos_stuck)
+                                            valueText: statusText(card.bit("gunA_pos_stuck"))
+                                            valueColor: statusColor(card.bit("gunA_pos_stuck"))
                                         }
                                         StatusRow {
                                             label: qsTr("正极接触器拒动")
-                                            valueText: statusText(model.gunA_pos_refuse)
-                                            valueColor: statusColor(model.gunA_pos_refuse)
+                                            valueText: statusText(card.bit("gunA_pos_refuse"))
+                                            valueColor: statusColor(card.bit("gunA_pos_refuse"))
                                         }
                                         StatusRow {
                                             label: qsTr("负极接触器粘连")
-                                            valueText: statusText(model.gunA_neg_stuck)
-                                            valueColor: statusColor(model.gunA_neg_stuck)
+                                            valueText: statusText(card.bit("gunA_neg_stuck"))
+                                            valueColor: statusColor(card.bit("gunA_neg_stuck"))
                                         }
                                         StatusRow {
                                             label: qsTr("负极接触器拒动")
-                                            valueText: statusText(model.gunA_neg_refuse)
-                                            valueColor: statusColor(model.gunA_neg_refuse)
+                                            valueText: statusText(card.bit("gunA_neg_refuse"))
+                                            valueColor: statusColor(card.bit("gunA_neg_refuse"))
                                         }
                                     }
                                 }
@@ -434,23 +419,23 @@ Item {
 
                                         StatusRow {
                                             label: qsTr("正极接触器粘连")
-                                            valueText: statusText(model.gunB_pos_stuck)
-                                            valueColor: statusColor(model.gunB_pos_stuck)
+                                            valueText: statusText(card.bit("gunB_pos_stuck"))
+                                            valueColor: statusColor(card.bit("gunB_pos_stuck"))
                                         }
                                         StatusRow {
                                             label: qsTr("正极接触器拒动")
-                                            valueText: statusText(model.gunB_pos_refuse)
-                                            valueColor: statusColor(model.gunB_pos_refuse)
+                                            valueText: statusText(card.bit("gunB_pos_refuse"))
+                                            valueColor: statusColor(card.bit("gunB_pos_refuse"))
                                         }
                                         StatusRow {
                                             label: qsTr("负极接触器粘连")
-                                            valueText: statusText(model.gunB_neg_stuck)
-                                            valueColor: statusColor(model.gunB_neg_stuck)
+                                            valueText: statusText(card.bit("gunB_neg_stuck"))
+                                            valueColor: statusColor(card.bit("gunB_neg_stuck"))
                                         }
                                         StatusRow {
                                             label: qsTr("负极接触器拒动")
-                                            valueText: statusText(model.gunB_neg_refuse)
-                                            valueColor: statusColor(model.gunB_neg_refuse)
+                                            valueText: statusText(card.bit("gunB_neg_refuse"))
+                                            valueColor: statusColor(card.bit("gunB_neg_refuse"))
                                         }
                                     }
                                 }
@@ -28,7 +28,8 @@ Item {
             return
         }
         deviceId = id
-        // 直接通过 deviceId 加载最新的检查记录
+        DetailPrefetcher.markViewed(deviceId)
+        // 直接通过 deviceId 加载最新的检查记录（已预热时同步命中缓存）
         PileModel.loadFromDevice(deviceId)
     }
 
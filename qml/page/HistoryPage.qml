@@ -20,11 +20,58 @@ Page {
     }
 
     onDeviceIdChanged: {
+        resetFilter()
         if (deviceId.length > 0) {
             HistoryModel.load(deviceId, 20)
         }
     }
 
+    // 是否设置了任何筛选条件
+    readonly property bool filterActive: !okCheck.checked || !warnCheck.checked || !errorCheck.checked
+                                         || triggerCombo.currentIndex > 0
+                                         || fromField.text.length > 0 || toField.text.length > 0
+                                         || textField.text.length > 0
+
+    // 至少勾选一种状态才能筛选；全部取消时结果必然为空
+    readonly property bool anyStatusChecked: okCheck.checked || warnCheck.checked || errorCheck.checked
+
+    // 筛选在数据库中执行，这里只组装条件
+    // 截止日期只填日期时包含当天（C++ 侧换算为次日 00:00 的右开界）
+    function applyFilter() {
+        if (deviceId.length === 0) {
+            return
+        }
+        if (!filterActive) {
+            HistoryModel.load(deviceId, 20)
+            return
+        }
+
+        var statuses = []
+        if (okCheck.checked) statuses.push("OK")
+        if (warnCheck.checked) statuses.push("WARN")
+        if (errorCheck.checked) statuses.push("ERROR")
+
+        HistoryModel.search({
+            deviceIds: [deviceId],
+            statuses: statuses,
+            triggerSources: triggerCombo.currentIndex > 0 ? [triggerCombo.currentText] : [],
+            from: fromField.text,
+            to: toField.text,
+            text: textField.text,
+            limit: 20
+        })
+    }
+
+    function resetFilter() {
+        okCheck.checked = true
+        warnCheck.checked = true
+        errorCheck.checked = true
+        triggerCombo.currentIndex = 0
+        fromField.text = ""
+        toField.text = ""
+        textField.text = ""
+    }
+
     background: Rectangle {
         color: AppTheme.backgroundPrimary
     }
@@ -61,14 +108,71 @@ Page {
 
             Button {
                 text: qsTr("刷新")
+                onClicked: page.applyFilter()
+            }
+        }
+
+        // Filter bar
+        Flow {
+            Layout.fillWidth: true
+            spacing: AppLayout.spacingMedium
+
+            CheckBox { id: okCheck; text: "OK"; checked: true }
+            CheckBox { id: warnCheck; text: "WARN"; checked: true }
+            CheckBox { id: errorCheck; text: "ERROR"; checked: true }
+
+            ComboBox {
+                id: triggerCombo
+                width: 120
+                model: [qsTr("全部来源"), "LOCAL", "WEB", "CLOUD", "AUTO"]
+            }
+
+            TextField {
+                id: fromField
+                width: 130
+                placeholderText: qsTr("起始 yyyy-MM-dd")
+                inputMethodHints: Qt.ImhDate
+            }
+
+            TextField {
+                id: toField
+                width: 130
+                placeholderText: qsTr("截止 yyyy-MM-dd")
+                inputMethodHints: Qt.ImhDate
+            }
+
+            TextField {
+                id: textField
+                width: 180
+                placeholderText: qsTr("摘要包含...")
+                onAccepted: page.applyFilter()
+            }
+
+            Button {
+                text: qsTr("筛选")
+                highlighted: true
+                enabled: page.anyStatusChecked
+                onClicked: page.applyFilter()
+            }
+
+            Button {
+                text: qsTr("重置")
+                enabled: page.filterActive
                 onClicked: {
-                    if (deviceId.length > 0) {
-                        HistoryModel.load(deviceId, 20)
-                    }
+                    page.resetFilter()
+                    page.applyFilter()
                 }
             }
         }
 
+        Label {
+            Layout.fillWidth: true
+            visible: HistoryModel.lastError.length > 0
+            text: HistoryModel.lastError
+            color: AppTheme.error
+            wrapMode: Text.WordWrap
+        }
+
         // List content
         Frame {
             Layout.fillWidth: true
@@ -152,11 +256,21 @@ Page {
 
                 ScrollBar.vertical: ScrollBar { policy: ScrollBar.AsNeeded }
 
+                // 滚动到底部时按游标加载下一页
+                onAtYEndChanged: {
+                    if (atYEnd && HistoryModel.hasMore && !HistoryModel.loading) {
+                        HistoryModel.loadMore()
+                    }
+                }
+
                 footer: Label {
                     width: historyList.width
                     horizontalAlignment: Text.AlignHCenter
                     padding: AppLayout.spacingMedium
-                            text: historyList.count === 0 ? qsTr("暂无历史记录") : qsTr("已加载全部记录")
+                    text: historyList.count === 0 && !HistoryModel.loading ? qsTr("暂无历史记录")
+                          : HistoryModel.loading ? qsTr("加载中...")
+                          : HistoryModel.hasMore ? qsTr("上拉加载更多")
+                          : qsTr("已加载全部记录")
                     color: AppTheme.foregroundSecondary
                 }
             }
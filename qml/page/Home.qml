@@ -17,7 +17,49 @@ Page {
         color: AppTheme.backgroundPrimary
     }
 
+    // 滚动停下后把可见区域内的设备交给 DetailPrefetcher 预热详情
+    function collectVisibleDevices() {
+        if (!deviceFlow.visible) {
+            DetailPrefetcher.setVisible([])
+            return
+        }
+        const top = scrollView.contentItem.contentY - deviceFlow.y
+        const bottom = top + scrollView.height
+        // Flow 逐行排列，子项 y 单调不减：二分找到第一个可见的卡片
+        let lo = 0
+        let hi = deviceRepeater.count
+        while (lo < hi) {
+            const mid = (lo + hi) >> 1
+            const it = deviceRepeater.itemAt(mid)
+            if (it && it.y + it.height < top)
+                lo = mid + 1
+            else
+                hi = mid
+        }
+        const ids = []
+        for (let i = lo; i < deviceRepeater.count; ++i) {
+            const it = deviceRepeater.itemAt(i)
+            if (!it || it.y > bottom)
+                break
+            if (it.item)
+                ids.push(it.item.deviceId)
+        }
+        DetailPrefetcher.setVisible(ids)
+    }
+
+    Timer {
+        id: visibleTimer
+        interval: 300
+        onTriggered: page.collectVisibleDevices()
+    }
+
+    Connections {
+        target: scrollView.contentItem
+        function onContentYChanged() { visibleTimer.restart() }
+    }
+
     ScrollView {
+        id: scrollView
         anchors.fill: parent
         clip: true
         contentWidth: availableWidth
@@ -26,29 +68,146 @@ Page {
             width: parent.width
             spacing: AppLayout.spacingLarge
 
-            // 顶部统计或标题区域（可选，这里先留白或保留原来的逻辑）
-            
+            // 过滤 / 排序栏（过滤与排序都在 C++ 的 DeviceFilterModel 中完成）
+            Flow {
+                Layout.fillWidth: true
+                Layout.leftMargin: AppLayout.marginLarge
+                Layout.rightMargin: AppLayout.marginLarge
+                Layout.topMargin: AppLayout.marginMedium
+                spacing: AppLayout.spacingMedium
+
+                TextField {
+                    id: searchField
+                    width: 220
+                    placeholderText: qsTr("搜索名称 / 设备编号")
+                    text: DeviceFilterModel.searchText
+                    onTextEdited: DeviceFilterModel.searchText = text
+                }
+
+                ComboBox {
+                    id: stationCombo
+                    width: 160
+                    // 第一项为“全部站点”，其余为已加载设备出现过的站点
+                    model: [qsTr("全部站点")].concat(DeviceFilterModel.stations)
+                    onActivated: function(index) {
+                        DeviceFilterModel.stationNo = index === 0 ? "" : currentText
+                    }
+                }
+
+                CheckBox {
+                    text: qsTr("仅离线")
+                    checked: DeviceFilterModel.offlineOnly
+                    onToggled: DeviceFilterModel.offlineOnly = checked
+                }
+
+                CheckBox {
+                    text: qsTr("仅自检失败")
+                    checked: DeviceFilterModel.failedOnly
+                    onToggled: DeviceFilterModel.failedOnly = checked
+                }
+
+                ComboBox {
+                    id: sortCombo
+                    width: 160
+                    textRole: "text"
+                    valueRole: "value"
+                    model: [
+                        { text: qsTr("按名称"), value: DeviceFilterModel.SortByName },
+                        { text: qsTr("按故障等级"), value: DeviceFilterModel.SortBySeverity },
+                        { text: qsTr("按最后自检"), value: DeviceFilterModel.SortByLastCheck }
+                    ]
+                    Component.onCompleted: currentIndex = indexOfValue(DeviceFilterModel.sortKey)
+                    onActivated: {
+                        DeviceFilterModel.sortKey = currentValue
+                        // 故障等级、自检时间默认从高到低
+                        DeviceFilterModel.sortDescending = currentValue !== DeviceFilterModel.SortByName
+                    }
+                }
+
+                ToolButton {
+                    text: DeviceFilterModel.sortDescending ? "↓" : "↑"
+                    onClicked: DeviceFilterModel.sortDescending = !DeviceFilterModel.sortDescending
+                }
+
+                Label {
+                    height: searchField.height
+                    verticalAlignment: Text.AlignVCenter
+                    color: AppTheme.textSecondary
+                    text: qsTr("%1 / %2 台").arg(DeviceFilterModel.count).arg(DeviceFilterModel.totalCount)
+                }
+
+                Switch {
+                    id: groupSwitch
+                    text: qsTr("按站点分组")
+                }
+
+                Button {
+                    text: qsTr("清除")
+                    flat: true
+                    onClicked: {
+                        DeviceFilterModel.clearFilters()
+                        stationCombo.currentIndex = 0
+                    }
+                }
+            }
+
+            // 按站点分组视图：只在打开时创建
+            Loader {
+                Layout.fillWidth: true
+                Layout.margins: AppLayout.marginLarge
+                Layout.preferredHeight: item ? item.contentHeight : 0
+                active: groupSwitch.checked
+                visible: active
+
+                sourceComponent: StationTree {
+                    interactive: false // 由外层 ScrollView 负责滚动
+                    onDeviceActivated: function(deviceId) {
+                        toItemDetailPageRequested(deviceId)
+                    }
+                }
+            }
+
             // 设备列表区域
             Flow {
+                id: deviceFlow
                 Layout.fillWidth: true
                 Layout.margins: AppLayout.marginLarge
                 spacing: AppLayout.spacingMedium
+                visible: !groupSwitch.checked
+                onVisibleChanged: visibleTimer.restart()
 
                 Repeater {
-                    model: DeviceModel
+                    id: deviceRepeater
+                    model: DeviceFilterModel
+                    onCountChanged: visibleTimer.restart()
 
                     Loader {
                         id: cardLoader
                         // TODO(@liangyu) 目前只有充电桩卡片，后续可根据 model.type 选择不同组件
                         sourceComponent: chargingPileCardComponent 
 
-                        onLoaded: {
-                            // 一次性设置不需要动态更新的属性
-                            item.deviceId = model.equipNo
-                            item.name = model.name
-                            item.ipAddress = model.ipAddr || ""
-                            // item.checkProgress = ... // 需要 C++ 提供
-                            // item.checkTotal = ...
+                        // 排序变化时 DeviceFilterModel 发 layoutChanged，代理保留并
+                        // 改绑到新行，因此标识类属性也必须用 Binding，不能只在 onLoaded 里赋值
+                        // item.checkProgress / checkTotal 需要 C++ 提供
+                        Binding {
+                            target: cardLoader.item
+                            property: "deviceId"
+                            value: model.equipNo
+                            when: cardLoader.item !== null
+                        }
+
+                        Binding {
+                            target: cardLoader.item
+                            property: "name"
+                            value: model.name
+                            when: cardLoader.item !== null
+                        }
+
+                        Binding {
+                            target: cardLoader.item
+                            property: "ipAddress"
+                            value: model.ipAddr || ""
+                            when: cardLoader.item !== null
                         }
 
                         // 使用 Binding 元素绑定需要动态更新的属性
@@ -14,7 +14,13 @@
 #include "client/mysql_client.h"
 #include "client/rabbitmq_client.h"
 #include "client/redis_client.h"
+#include "db/db_table.h"
+#include "db/query_metrics.h"
+#include "device/ccu_codec.h"
+#include "device/ccu_fault.h"
+#include "device/device_repo.h"
 #include "device/device_object.h"
+#include "device/device_registry.h"
 #include "model/device_model.h"
 #include "utils/convert.h"
 
@@ -85,6 +91,8 @@ void CheckManager::recvMsg(const std::string &message) {
     }
 
     std::string pile_id = data["pileId"].get<std::string>();
+    // 一次解析出设备句柄，后续 UI 更新不再按字符串查找
+    const auto handle = device::DeviceRegistry::Instance().find(pile_id);
     std::string desc = data.value("desc", "");
     std::string state = data.value("state", "");
     int result = 0;
@@ -123,7 +131,7 @@ void CheckManager::recvMsg(const std::string &message) {
                  << " 检测中=" << is_checking << " 已完成=" << is_finished;
 
       if (device_model_ != nullptr) {
-        device_model_->updateSelfCheckProgress(pile_id, desc, is_checking);
+        device_model_->updateSelfCheckProgress(handle, desc, is_checking);
       }
     }
     // 处理最终结果格式 (ReqType)
@@ -162,7 +170,7 @@ void CheckManager::recvMsg(const std::string &message) {
       // Update UI
       if (device_model_ != nullptr) {
         // 更新进度为完成
-        device_model_->updateSelfCheckProgress(pile_id, final_desc, false);
+        device_model_->updateSelfCheckProgress(handle, final_desc, false);
 
         // 构建并更新最终结果
         device::SelfCheckResult check_result;
@@ -183,7 +191,7 @@ void CheckManager::recvMsg(const std::string &message) {
           check_result.status = device::SelfCheckStatus::Failed;
         }
 
-        device_model_->updateSelfCheck(pile_id, check_result);
+        device_model_->updateSelfCheck(handle, check_result);
       }
     } else {
       LOG(WARNING) << "消息格式无效，缺少 NoticeType 或 ReqType";
@@ -232,9 +240,11 @@ CheckManager::getResultFromRedis(const std::string &device_id) {
     if (hash_opt->empty()) {
       return absl::NotFoundError("Redis hash empty: " + module_key);
     }
-    auto hash = *hash_opt;
-    hash["index"] = module_key.substr(module_key.find_last_of('#') + 1);
-    auto attributes = utils::ToCCUAttr(hash);
+    const int index = utils::ParseModuleIndex(module_key);
+    if (index < 0) {
+      return absl::InvalidArgumentError("Bad CCU module key: " + module_key);
+    }
+    auto attributes = utils::ToCCUAttr(*hash_opt, index);
     if (!attributes.ok()) {
       return attributes.status();
     }
@@ -252,6 +262,7 @@ CheckManager::getResultFromRedis(const std::string &device_id) {
 }
 
 absl::Status CheckManager::saveResultToMysql(const std::string &device_id) {
+  db::ScopedQueryOrigin origin("CheckManager.save");
   auto *mysql = db::MySqlClient::GetInstance();
   if (mysql == nullptr) {
     return absl::InternalError("MySQL client not initialized");
@@ -273,91 +284,23 @@ absl::Status CheckManager::saveResultToMysql(const std::string &device_id) {
   details_json["deviceName"] = device->Attributes().name;
   details_json["deviceType"] = device->Attributes().type;
 
-  int issue_count = 0;
   auto attributes_or = getResultFromRedis(device_id);
   if (!attributes_or.ok()) {
     return attributes_or.status();
   }
 
   std::vector<nlohmann::json> modules;
-  auto add_issue_if_true = [&issue_count](bool value) {
-    if (value) {
-      ++issue_count;
-    }
-  };
 
+  modules.reserve(attributes_or->size());
   for (const auto &attr : attributes_or.value()) {
-    nlohmann::json module_json; // NOLINT
-    module_json["index"] = attr.index;
-
-    module_json["acContactor1"] = {
-        {"refuse", attr.ac_contactor_1.contactor1_refuse},
-        {"stuck", attr.ac_contactor_1.contactor1_stuck}};
-    add_issue_if_true(attr.ac_contactor_1.contactor1_refuse);
-    add_issue_if_true(attr.ac_contactor_1.contactor1_stuck);
-
-    module_json["acContactor2"] = {
-        {"refuse", attr.ac_contactor_2.contactor1_refuse},
-        {"stuck", attr.ac_contactor_2.contactor1_stuck}};
-    add_issue_if_true(attr.ac_contactor_2.contactor1_refuse);
-    add_issue_if_true(attr.ac_contactor_2.contactor1_stuck);
-
-    module_json["parallelContactor"] = {
-        {"positiveRefuse", attr.parallel_contactor.positive_refuse},
-        {"positiveStuck", attr.parallel_contactor.positive_stuck},
-        {"negativeRefuse", attr.parallel_contactor.negative_refuse},
-        {"negativeStuck", attr.parallel_contactor.negative_stuck}};
-    add_issue_if_true(attr.parallel_contactor.positive_refuse);
-    add_issue_if_true(attr.parallel_contactor.positive_stuck);
-    add_issue_if_true(attr.parallel_contactor.negative_refuse);
-    add_issue_if_true(attr.parallel_contactor.negative_stuck);
-
-    module_json["fan1"] = {{"stopped", attr.fan_1.stopped},
-                           {"rotating", attr.fan_1.rotating}};
-    module_json["fan2"] = {{"stopped", attr.fan_2.stopped},
-                           {"rotating", attr.fan_2.rotating}};
-    module_json["fan3"] = {{"stopped", attr.fan_3.stopped},
-                           {"rotating", attr.fan_3.rotating}};
-    module_json["fan4"] = {{"stopped", attr.fan_4.stopped},
-                           {"rotating", attr.fan_4.rotating}};
-    add_issue_if_true(attr.fan_1.stopped);
-    add_issue_if_true(attr.fan_2.stopped);
-    add_issue_if_true(attr.fan_3.stopped);
-    add_issue_if_true(attr.fan_4.stopped);
-
-    module_json["gunA"] = {
-        {"positiveContactorRefuse", attr.gun_a.positive_contactor_refuse},
-        {"positiveContactorStuck", attr.gun_a.positive_contactor_stuck},
-        {"negativeContactorRefuse", attr.gun_a.negative_contactor_refuse},
-        {"negativeContactorStuck", attr.gun_a.negative_contactor_stuck},
-        {"unlocked", attr.gun_a.unlocked},
-        {"locked", attr.gun_a.locked},
-        {"auxPower12v", attr.gun_a.aux_power_12v},
-        {"auxPower24v", attr.gun_a.aux_power_24v}};
-    add_issue_if_true(attr.gun_a.positive_contactor_refuse);
-    add_issue_if_true(attr.gun_a.positive_contactor_stuck);
-    add_issue_if_true(attr.gun_a.negative_contactor_refuse);
-    add_issue_if_true(attr.gun_a.negative_contactor_stuck);
-
-    module_json["gunB"] = {
-        {"positiveContactorRefuse", attr.gun_b.positive_contactor_refuse},
-        {"positiveContactorStuck", attr.gun_b.positive_contactor_stuck},
-        {"negativeContactorRefuse", attr.gun_b.negative_contactor_refuse},
-        {"negativeContactorStuck", attr.gun_b.negative_contactor_stuck},
-        {"unlocked", attr.gun_b.unlocked},
-        {"locked", attr.gun_b.locked},
-        {"auxPower12v", attr.gun_b.aux_power_12v},
-        {"auxPower24v", attr.gun_b.aux_power_24v}};
-    add_issue_if_true(attr.gun_b.positive_contactor_refuse);
-    add_issue_if_true(attr.gun_b.positive_contactor_stuck);
-    add_issue_if_true(attr.gun_b.negative_contactor_refuse);
-    add_issue_if_true(attr.gun_b.negative_contactor_stuck);
-
-    modules.emplace_back(module_json);
+    modules.emplace_back(device::EncodeCcuModule(attr));
   }
 
   details_json["ccuModules"] = modules;
 
+  const auto faults = device::SummarizeFaults(attributes_or.value());
+  const int issue_count = faults.total();
+
   std::string status = "OK";
   std::string summary = "All CCU modules normal";
   if (!attributes_or.ok()) {
@@ -371,23 +314,90 @@ absl::Status CheckManager::saveResultToMysql(const std::string &device_id) {
   const std::string sql =
       "INSERT INTO self_check_record "
       "(Type, EquipNo, CheckCategory, Status, Summary, DetailsJSON, "
-      "TriggerSource, TriggeredBy) "
-      "VALUES (?, ?, ?, ?, ?, ?, ?, ?)";
+      "TriggerSource, TriggeredBy, CcuCount, FaultCcuCount, "
+      "AcContactorFaults, ParallelContactorFaults, FanFaults, GunFaults, "
+      "FaultMask) "
+      "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
 
   const std::string check_category = "FULL";
   const std::string trigger_source = "AUTO";
 
   std::vector<db::DbValue> params = {
       device_type, device_id,           check_category, status,
-      summary,     details_json.dump(), trigger_source, std::nullptr_t{}};
-
-  auto insert_result = mysql->executeUpdate(sql, params);
-  if (!insert_result.ok()) {
-    return insert_result.status();
+      summary,     details_json.dump(), trigger_source, std::nullptr_t{},
+      static_cast<int64_t>(faults.ccu_count),
+      static_cast<int64_t>(faults.fault_ccu_count),
+      static_cast<int64_t>(faults.ac_contactor_faults),
+      static_cast<int64_t>(faults.parallel_contactor_faults),
+      static_cast<int64_t>(faults.fan_faults),
+      static_cast<int64_t>(faults.gun_faults),
+      static_cast<int64_t>(faults.fault_mask)};
+
+  // 记录与日汇总在同一事务内写入，汇总表不会与明细不一致
+  int64_t record_id = 0;
+  std::string created_at;
+  auto tx_status = mysql->runInTransaction([&](db::Transaction &tx) {
+    auto inserted = tx.update(sql, params);
+    if (!inserted.ok()) {
+      return inserted.status();
+    }
+    // 必须在同一连接上、汇总写入之前读取
+    auto id = tx.lastInsertId();
+    if (!id.ok()) {
+      return id.status();
+    }
+    record_id = *id;
+    // 推送给历史页的时间取库中的 CreatedAt（会话时区），与重新查询的结果一致
+    auto rows = tx.query("SELECT CreatedAt FROM self_check_record "
+                         "WHERE ID = ? "
+                         "AND CreatedAt >= CURRENT_DATE - INTERVAL 1 DAY",
+                         {record_id});
+    if (!rows.ok()) {
+      return rows.status();
+    }
+    if (rows->empty()) {
+      return absl::InternalError("inserted self check record not found");
+    }
+    created_at = rows->front().getString("CreatedAt");
+    return db::AccumulateDailyRollup(tx);
+  });
+  if (!tx_status.ok()) {
+    return tx_status;
+  }
+  device::DeviceRepo::InvalidateLatest(device_id);
+
+  // 推送给正在查看历史的页面，免去整页重新查询
+  qml_model::HistoryItem item;
+  item.recordId = QString::number(record_id);
+  item.deviceId = QString::fromStdString(device_id);
+  // 与 DeviceRepo::SearchHistory 的解析方式相同
+  const auto ts_str = QString::fromStdString(created_at);
+  item.timestamp = QDateTime::fromString(ts_str, Qt::ISODate);
+  if (!item.timestamp.isValid()) {
+    item.timestamp = QDateTime::fromString(ts_str, "yyyy-MM-dd HH:mm:ss");
   }
+  item.status = QString::fromStdString(status);
+  item.summary = QString::fromStdString(summary);
+  item.ccuCount = faults.ccu_count;
+  item.faultCcuCount = faults.fault_ccu_count;
+  item.acContactorFaults = faults.ac_contactor_faults;
+  item.parallelContactorFaults = faults.parallel_contactor_faults;
+  item.fanFaults = faults.fan_faults;
+  item.gunFaults = faults.gun_faults;
+  item.faultMask = static_cast<quint32>(faults.fault_mask);
+  // 当前在 RabbitMQ 回调线程，信号投递到 UI 线程发出
+  QMetaObject::invokeMethod(
+      this,
+      [this, item = std::move(item),
+       category = QString::fromStdString(check_category),
+       trigger = QString::fromStdString(trigger_source)]() {
+        emit historyRecordSaved(item, category, trigger);
+      },
+      Qt::QueuedConnection);
 
   LOG(INFO) << "Saved self check record for " << device_id
-            << " status=" << status << " issues=" << issue_count;
+            << " id=" << record_id << " status=" << status
+            << " issues=" << issue_count;
   return absl::OkStatus();
 }
 
@@ -397,13 +407,13 @@ CheckManager::getRedisKey(const std::string &device_id) {
     return absl::InternalError("DeviceModel is not initialized");
   }
 
-  auto device = device_model_->getDeviceByEquipNo(device_id);
-  if (!device) {
+  // 模块 key 模式在设备注册时已拼好
+  const auto keys = device::DeviceRegistry::Instance().keys(
+      device::DeviceRegistry::Instance().find(device_id));
+  if (!keys) {
     LOG(WARNING) << "Device not found: " << device_id;
     return absl::NotFoundError("Device not found: " + device_id);
   }
-  const std::string &type = device->Attributes().type;
-  std::string modules_key = "selfcheck:" + type + "#" + device_id + ":CCU#*";
 
   auto *redis = client::RedisClient::GetInstance();
   if (redis == nullptr || !redis->IsConnected()) {
@@ -412,6 +422,6 @@ CheckManager::getRedisKey(const std::string &device_id) {
     return absl::InternalError("Redis client is not ready");
   }
 
-  return redis->Keys(modules_key);
+  return redis->Keys(keys->selfcheck_pattern);
 }
 } // namespace EAutoCheck
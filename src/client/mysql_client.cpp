@@ -59,6 +59,22 @@ Config Config::FromYamlFile(const std::string &path) {
     config.mysql.timeouts.write_timeout_ms =
         mysql["write_timeout_ms"].as<int>();
 
+  if (root["pool"]) {
+    const auto pool = root["pool"];
+    if (pool["enabled"])
+      config.pool.enabled = pool["enabled"].as<bool>();
+    if (pool["max_size"])
+      config.pool.max_size = pool["max_size"].as<int>();
+    if (pool["acquire_timeout_ms"])
+      config.pool.acquire_timeout_ms = pool["acquire_timeout_ms"].as<int>();
+    if (pool["keepalive_sec"])
+      config.pool.keepalive_sec = pool["keepalive_sec"].as<int>();
+  }
+  if (!config.pool.enabled || config.pool.max_size < 1) {
+    // 关闭连接池时退化为单连接
+    config.pool.max_size = 1;
+  }
+
   if (root["retry"]) {
     const auto retry = root["retry"];
     if (retry["max_retries"])
@@ -73,6 +89,9 @@ Config Config::FromYamlFile(const std::string &path) {
       config.behavior.timezone = behavior["timezone"].as<std::string>();
     if (behavior["slow_sql_ms"])
       config.behavior.slow_sql_ms = behavior["slow_sql_ms"].as<int>();
+    if (behavior["metrics_dump_sec"])
+      config.behavior.metrics_dump_sec =
+          behavior["metrics_dump_sec"].as<int>();
   }
 
   return config;
@@ -134,6 +153,81 @@ static std::vector<DbRow> FetchAll(sql::ResultSet *res) {
   return rows;
 }
 
+static std::chrono::microseconds
+ToMicros(std::chrono::steady_clock::duration d) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(d);
+}
+
+// ---------------------------
+// Statement execution (one connection, fills prepare/execute/fetch timing)
+// ---------------------------
+static std::vector<DbRow> RunQuery(sql::Connection *conn,
+                                   const std::string &sql,
+                                   const std::vector<DbValue> &params,
+                                   QueryTiming &timing) {
+  const auto t_begin = std::chrono::steady_clock::now();
+  std::unique_ptr<sql::Statement> regular_stmt;
+  std::unique_ptr<sql::PreparedStatement> stmt;
+  std::unique_ptr<sql::ResultSet> res;
+  std::chrono::steady_clock::time_point t_prepared;
+
+  if (params.empty()) {
+    // No parameters, use regular statement
+    regular_stmt.reset(conn->createStatement());
+    t_prepared = std::chrono::steady_clock::now();
+    res.reset(regular_stmt->executeQuery(sql));
+  } else {
+    // Has parameters, use prepared statement
+    stmt.reset(conn->prepareStatement(sql));
+    BindParams(stmt.get(), params);
+    t_prepared = std::chrono::steady_clock::now();
+    res.reset(stmt->executeQuery());
+  }
+  const auto t_executed = std::chrono::steady_clock::now();
+
+  auto rows = FetchAll(res.get());
+  const auto t_fetched = std::chrono::steady_clock::now();
+
+  timing.prepare += ToMicros(t_prepared - t_begin);
+  timing.execute += ToMicros(t_executed - t_prepared);
+  timing.fetch += ToMicros(t_fetched - t_executed);
+  return rows;
+}
+
+static uint64_t RunUpdate(sql::Connection *conn, const std::string &sql,
+                          const std::vector<DbValue> &params,
+                          QueryTiming &timing) {
+  const auto t_begin = std::chrono::steady_clock::now();
+  std::unique_ptr<sql::Statement> regular_stmt;
+  std::unique_ptr<sql::PreparedStatement> stmt;
+  std::chrono::steady_clock::time_point t_prepared;
+  int affected = 0;
+
+  if (params.empty()) {
+    // No parameters, use regular statement
+    regular_stmt.reset(conn->createStatement());
+    t_prepared = std::chrono::steady_clock::now();
+    affected = regular_stmt->executeUpdate(sql);
+  } else {
+    // Has parameters, use prepared statement
+    stmt.reset(conn->prepareStatement(sql));
+    BindParams(stmt.get(), params);
+    t_prepared = std::chrono::steady_clock::now();
+    affected = stmt->executeUpdate();
+  }
+  const auto t_executed = std::chrono::steady_clock::now();
+
+  timing.prepare += ToMicros(t_prepared - t_begin);
+  timing.execute += ToMicros(t_executed - t_prepared);
+  return static_cast<uint64_t>(affected);
+}
+
+// 死锁 / 锁等待超时：整个事务可安全重放
+static bool IsRetryableTxError(int code) {
+  return code == 1213 || // ER_LOCK_DEADLOCK
+         code == 1205;   // ER_LOCK_WAIT_TIMEOUT
+}
+
 // ---------------------------
 // Retry helper
 // ---------------------------
@@ -160,6 +254,39 @@ auto WithRetry(const RetryConfig &rc, Fn &&fn) -> decltype(fn()) {
   }
 }
 
+// ---------------------------
+// Connection lease
+// ---------------------------
+class MySqlClient::ConnectionLease {
+public:
+  ConnectionLease(MySqlClient *owner, std::unique_ptr<sql::Connection> conn)
+      : owner_(owner), conn_(std::move(conn)) {}
+
+  ~ConnectionLease() {
+    if (conn_) {
+      owner_->releaseConnection(std::move(conn_), reusable_);
+    }
+  }
+
+  ConnectionLease(ConnectionLease &&other) noexcept
+      : owner_(other.owner_), conn_(std::move(other.conn_)),
+        reusable_(other.reusable_) {}
+  ConnectionLease(const ConnectionLease &) = delete;
+  ConnectionLease &operator=(const ConnectionLease &) = delete;
+  ConnectionLease &operator=(ConnectionLease &&) = delete;
+
+  sql::Connection *operator->() const { return conn_.get(); }
+  sql::Connection *get() const { return conn_.get(); }
+
+  // 连接出错后不再放回池中
+  void discard() { reusable_ = false; }
+
+private:
+  MySqlClient *owner_;
+  std::unique_ptr<sql::Connection> conn_;
+  bool reusable_ = true;
+};
+
 // ---------------------------
 // MySqlClient impl (JDBC Classic Protocol)
 // ---------------------------
@@ -170,10 +297,14 @@ void MySqlClient::Init(const Config &cfg) {
   std::lock_guard<std::mutex> lock(instance_mutex_);
   if (!instance_) {
     instance_.reset(new MySqlClient(cfg));
+    // 线程数与连接数一致：DB 线程拿到任务后不会再排队等连接
+    DbExecutor::SetMaxThreads(cfg.pool.max_size);
   }
 }
 
 void MySqlClient::Shutdown() {
+  // 先等待在途的异步查询结束，再销毁连接池
+  DbExecutor::WaitForDone();
   std::lock_guard<std::mutex> lock(instance_mutex_);
   instance_.reset();
 }
@@ -188,31 +319,33 @@ MySqlClient *MySqlClient::GetInstance() {
 
 MySqlClient::MySqlClient(const Config &cfg) : cfg_(cfg) {
   // Lazy connection - don't connect here, connect on first use
+  if (cfg_.behavior.metrics_dump_sec > 0) {
+    metrics_thread_ = std::thread([this]() { metricsDumpLoop(); });
+  }
 }
 
-MySqlClient::~MySqlClient() = default;
-
-void MySqlClient::ensureConnection() {
-  std::lock_guard<std::mutex> lock(connection_mutex_);
-  ensureConnectionUnlocked();
+MySqlClient::~MySqlClient() {
+  {
+    std::lock_guard<std::mutex> lock(metrics_thread_mutex_);
+    stopping_ = true;
+  }
+  metrics_thread_cv_.notify_all();
+  if (metrics_thread_.joinable()) {
+    metrics_thread_.join();
+  }
+  LOG(INFO) << metrics_.report();
 }
 
-void MySqlClient::ensureConnectionUnlocked() {
-  // This method assumes connection_mutex_ is already locked
-  if (connection_) {
-    // Connection exists, try a simple ping to verify it's alive
-    try {
-      std::unique_ptr<sql::Statement> stmt(connection_->createStatement());
-      std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT 1"));
-      res->next(); // Consume result
-      return;
-    } catch (const sql::SQLException &) {
-      // Connection is dead, reset it
-      connection_.reset();
-    }
+void MySqlClient::metricsDumpLoop() {
+  const auto interval = std::chrono::seconds(cfg_.behavior.metrics_dump_sec);
+  std::unique_lock<std::mutex> lock(metrics_thread_mutex_);
+  while (!metrics_thread_cv_.wait_for(lock, interval,
+                                      [this]() { return stopping_; })) {
+    LOG(INFO) << metrics_.report();
   }
+}
 
-  // Create new connection
+std::unique_ptr<sql::Connection> MySqlClient::createConnection() {
   sql::Driver *driver = sql::mysql::get_driver_instance();
   if (!driver) {
     throw DatabaseError("Failed to get MySQL driver instance");
@@ -227,17 +360,17 @@ void MySqlClient::ensureConnectionUnlocked() {
             << cfg_.mysql.endpoint.port;
 
   // Connect using driver->connect(url, user, pass) as per JDBC API
-  connection_.reset(driver->connect(url.str(), cfg_.mysql.endpoint.user,
-                                    cfg_.mysql.endpoint.password));
+  std::unique_ptr<sql::Connection> conn(driver->connect(
+      url.str(), cfg_.mysql.endpoint.user, cfg_.mysql.endpoint.password));
 
   // Set schema (database)
   if (!cfg_.mysql.endpoint.database.empty()) {
-    connection_->setSchema(cfg_.mysql.endpoint.database);
+    conn->setSchema(cfg_.mysql.endpoint.database);
   }
 
   // Set charset if specified
   if (!cfg_.mysql.charset.empty()) {
-    std::unique_ptr<sql::Statement> stmt(connection_->createStatement());
+    std::unique_ptr<sql::Statement> stmt(conn->createStatement());
     std::ostringstream charset_sql;
     charset_sql << "SET NAMES '" << cfg_.mysql.charset << "'";
     stmt->execute(charset_sql.str());
@@ -245,67 +378,149 @@ void MySqlClient::ensureConnectionUnlocked() {
 
   // Set timezone if specified
   if (!cfg_.behavior.timezone.empty()) {
-    std::unique_ptr<sql::Statement> stmt(connection_->createStatement());
+    std::unique_ptr<sql::Statement> stmt(conn->createStatement());
     std::ostringstream tz_sql;
     tz_sql << "SET time_zone='" << cfg_.behavior.timezone << "'";
     stmt->execute(tz_sql.str());
   }
+
+  return conn;
+}
+
+MySqlClient::ConnectionLease MySqlClient::acquireConnection() {
+  const auto deadline =
+      std::chrono::steady_clock::now() +
+      std::chrono::milliseconds(cfg_.pool.acquire_timeout_ms);
+
+  std::unique_lock<std::mutex> lock(pool_mutex_);
+  while (true) {
+    if (!idle_.empty()) {
+      IdleConnection idle = std::move(idle_.back());
+      idle_.pop_back();
+
+      const auto idle_for = std::chrono::steady_clock::now() - idle.last_used;
+      if (idle_for < std::chrono::seconds(cfg_.pool.keepalive_sec)) {
+        return ConnectionLease(this, std::move(idle.conn));
+      }
+
+      // 空闲过久，探活后再用（探活在锁外进行）
+      lock.unlock();
+      try {
+        std::unique_ptr<sql::Statement> stmt(idle.conn->createStatement());
+        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT 1"));
+        res->next(); // Consume result
+        return ConnectionLease(this, std::move(idle.conn));
+      } catch (const sql::SQLException &) {
+        // Connection is dead, drop it and try again
+        idle.conn.reset();
+        lock.lock();
+        --open_count_;
+        pool_cv_.notify_one();
+        continue;
+      }
+    }
+
+    if (open_count_ < cfg_.pool.max_size) {
+      ++open_count_;
+      lock.unlock();
+      try {
+        return ConnectionLease(this, createConnection());
+      } catch (...) {
+        lock.lock();
+        --open_count_;
+        pool_cv_.notify_one();
+        throw;
+      }
+    }
+
+    if (pool_cv_.wait_until(lock, deadline) == std::cv_status::timeout &&
+        idle_.empty() && open_count_ >= cfg_.pool.max_size) {
+      throw DatabaseError("Timed out acquiring MySQL connection from pool");
+    }
+  }
+}
+
+void MySqlClient::releaseConnection(std::unique_ptr<sql::Connection> conn,
+                                    bool reusable) {
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    if (reusable) {
+      idle_.push_back({std::move(conn), std::chrono::steady_clock::now()});
+    } else {
+      --open_count_;
+    }
+  }
+  pool_cv_.notify_one();
+  // 不可复用的连接在锁外析构（可能涉及网络 IO）
+  conn.reset();
 }
 
 void MySqlClient::reconnect() {
-  std::lock_guard<std::mutex> lock(connection_mutex_);
   LOG(WARNING) << "Reconnecting to " << cfg_.mysql.endpoint.host << ":"
                << cfg_.mysql.endpoint.port;
-  connection_.reset();
-  ensureConnectionUnlocked();
+  std::vector<IdleConnection> stale;
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    stale.swap(idle_);
+    open_count_ -= static_cast<int>(stale.size());
+  }
+  pool_cv_.notify_all();
+  // 借出中的连接出错时会各自 discard，这里只清理空闲连接
+}
+
+void MySqlClient::logStatement(const std::string &sql,
+                               std::chrono::steady_clock::time_point start,
+                               std::chrono::steady_clock::time_point end,
+                               const char *what, uint64_t count) const {
+  const auto dur =
+      std::chrono::duration_cast<std::chrono::milliseconds>(end - start)
+          .count();
+  if (dur >= cfg_.behavior.slow_sql_ms) {
+    LOG(WARNING) << "[SLOW " << dur << "ms] " << sql;
+  } else {
+    VLOG(1) << "[OK " << dur << "ms] " << what << "=" << count;
+  }
 }
 
 absl::StatusOr<std::vector<DbRow>>
 MySqlClient::executeQuery(const std::string &sql,
                           const std::vector<DbValue> &params) {
   const auto start = std::chrono::steady_clock::now();
+  QueryTiming timing;
   auto work = [&]() -> std::vector<DbRow> {
-    std::lock_guard<std::mutex> lock(connection_mutex_);
-    ensureConnectionUnlocked();
-
-    std::unique_ptr<sql::PreparedStatement> stmt;
-    std::unique_ptr<sql::ResultSet> res;
-
-    if (params.empty()) {
-      // No parameters, use regular statement
-      std::unique_ptr<sql::Statement> regular_stmt(
-          connection_->createStatement());
-      res.reset(regular_stmt->executeQuery(sql));
-    } else {
-      // Has parameters, use prepared statement
-      stmt.reset(connection_->prepareStatement(sql));
-      BindParams(stmt.get(), params);
-      res.reset(stmt->executeQuery());
-    }
-
-    auto rows = FetchAll(res.get());
-
-    const auto dur = std::chrono::duration_cast<std::chrono::milliseconds>(
-                         std::chrono::steady_clock::now() - start)
-                         .count();
-    if (dur >= cfg_.behavior.slow_sql_ms) {
-      LOG(WARNING) << "[SLOW " << dur << "ms] " << sql;
-    } else {
-      LOG(INFO) << "[OK " << dur << "ms] rows=" << rows.size();
+    const auto t_begin = std::chrono::steady_clock::now();
+    auto conn = acquireConnection();
+    timing.acquire_wait += ToMicros(std::chrono::steady_clock::now() - t_begin);
+    try {
+      auto rows = RunQuery(conn.get(), sql, params, timing);
+      logStatement(sql, start, std::chrono::steady_clock::now(), "rows",
+                   rows.size());
+      return rows;
+    } catch (const sql::SQLException &) {
+      conn.discard();
+      throw;
     }
+  };
 
-    return rows;
+  auto finish = [&](uint64_t rows, bool ok) {
+    timing.total = ToMicros(std::chrono::steady_clock::now() - start);
+    metrics_.record(sql, timing, rows, ok);
   };
 
   try {
-    return WithRetry(cfg_.retry, work);
+    auto rows = WithRetry(cfg_.retry, work);
+    finish(rows.size(), true);
+    return rows;
   } catch (const sql::SQLException &e) {
     // Try to reconnect on error
     try {
       reconnect();
       // Retry once after reconnect
-      return WithRetry(cfg_.retry, work);
+      auto rows = WithRetry(cfg_.retry, work);
+      finish(rows.size(), true);
+      return rows;
     } catch (...) {
+      finish(0, false);
       std::ostringstream oss;
       oss << "Query failed: " << e.what() << " (Error: " << e.getErrorCode()
           << ")";
@@ -313,6 +528,7 @@ MySqlClient::executeQuery(const std::string &sql,
       return absl::InternalError(oss.str());
     }
   } catch (const std::exception &e) {
+    finish(0, false);
     std::ostringstream oss;
     oss << "Query failed: " << e.what();
     LOG(ERROR) << oss.str() << " SQL=" << sql;
@@ -324,46 +540,41 @@ absl::StatusOr<uint64_t>
 MySqlClient::executeUpdate(const std::string &sql,
                            const std::vector<DbValue> &params) {
   const auto start = std::chrono::steady_clock::now();
+  QueryTiming timing;
   auto work = [&]() -> uint64_t {
-    std::lock_guard<std::mutex> lock(connection_mutex_);
-    ensureConnectionUnlocked();
-
-    std::unique_ptr<sql::PreparedStatement> stmt;
-    int affected = 0;
-
-    if (params.empty()) {
-      // No parameters, use regular statement
-      std::unique_ptr<sql::Statement> regular_stmt(
-          connection_->createStatement());
-      affected = regular_stmt->executeUpdate(sql);
-    } else {
-      // Has parameters, use prepared statement
-      stmt.reset(connection_->prepareStatement(sql));
-      BindParams(stmt.get(), params);
-      affected = stmt->executeUpdate();
-    }
-
-    const auto dur = std::chrono::duration_cast<std::chrono::milliseconds>(
-                         std::chrono::steady_clock::now() - start)
-                         .count();
-    if (dur >= cfg_.behavior.slow_sql_ms) {
-      LOG(WARNING) << "[SLOW " << dur << "ms] " << sql;
-    } else {
-      LOG(INFO) << "[OK " << dur << "ms] affected=" << affected;
+    const auto t_begin = std::chrono::steady_clock::now();
+    auto conn = acquireConnection();
+    timing.acquire_wait += ToMicros(std::chrono::steady_clock::now() - t_begin);
+    try {
+      const auto affected = RunUpdate(conn.get(), sql, params, timing);
+      logStatement(sql, start, std::chrono::steady_clock::now(), "affected",
+                   affected);
+      return affected;
+    } catch (const sql::SQLException &) {
+      conn.discard();
+      throw;
     }
+  };
 
-    return static_cast<uint64_t>(affected);
+  auto finish = [&](uint64_t affected, bool ok) {
+    timing.total = ToMicros(std::chrono::steady_clock::now() - start);
+    metrics_.record(sql, timing, affected, ok);
   };
 
   try {
-    return WithRetry(cfg_.retry, work);
+    const auto affected = WithRetry(cfg_.retry, work);
+    finish(affected, true);
+    return affected;
   } catch (const sql::SQLException &e) {
     // Try to reconnect on error
     try {
       reconnect();
       // Retry once after reconnect
-      return WithRetry(cfg_.retry, work);
+      const auto affected = WithRetry(cfg_.retry, work);
+      finish(affected, true);
+      return affected;
     } catch (...) {
+      finish(0, false);
       std::ostringstream oss;
       oss << "Update failed: " << e.what() << " (Error: " << e.getErrorCode()
           << ")";
@@ -371,6 +582,7 @@ MySqlClient::executeUpdate(const std::string &sql,
       return absl::InternalError(oss.str());
     }
   } catch (const std::exception &e) {
+    finish(0, false);
     std::ostringstream oss;
     oss << "Update failed: " << e.what();
     LOG(ERROR) << oss.str() << " SQL=" << sql;
@@ -378,18 +590,166 @@ MySqlClient::executeUpdate(const std::string &sql,
   }
 }
 
+QFuture<absl::StatusOr<std::vector<DbRow>>>
+MySqlClient::executeQueryAsync(std::string sql, std::vector<DbValue> params,
+                               QueryPriority priority) {
+  return DbExecutor::Submit(
+      priority, [this, sql = std::move(sql), params = std::move(params)]() {
+        return executeQuery(sql, params);
+      });
+}
+
+QFuture<absl::StatusOr<uint64_t>>
+MySqlClient::executeUpdateAsync(std::string sql, std::vector<DbValue> params,
+                                QueryPriority priority) {
+  return DbExecutor::Submit(
+      priority, [this, sql = std::move(sql), params = std::move(params)]() {
+        return executeUpdate(sql, params);
+      });
+}
+
+// ---------------------------
+// Transaction
+// ---------------------------
+absl::StatusOr<std::vector<DbRow>>
+Transaction::query(const std::string &sql, const std::vector<DbValue> &params) {
+  const auto start = std::chrono::steady_clock::now();
+  QueryTiming timing;
+  try {
+    auto rows = RunQuery(conn_, sql, params, timing);
+    const auto end = std::chrono::steady_clock::now();
+    timing.total = ToMicros(end - start);
+    owner_->metrics_.record(sql, timing, rows.size(), true);
+    owner_->logStatement(sql, start, end, "rows", rows.size());
+    return rows;
+  } catch (const sql::SQLException &e) {
+    timing.total = ToMicros(std::chrono::steady_clock::now() - start);
+    owner_->metrics_.record(sql, timing, 0, false);
+    last_error_code_ = e.getErrorCode();
+    std::ostringstream oss;
+    oss << "Query failed in transaction: " << e.what()
+        << " (Error: " << e.getErrorCode() << ")";
+    LOG(ERROR) << oss.str() << " SQL=" << sql;
+    return absl::InternalError(oss.str());
+  }
+}
+
+absl::StatusOr<uint64_t>
+Transaction::update(const std::string &sql,
+                    const std::vector<DbValue> &params) {
+  const auto start = std::chrono::steady_clock::now();
+  QueryTiming timing;
+  try {
+    const auto affected = RunUpdate(conn_, sql, params, timing);
+    const auto end = std::chrono::steady_clock::now();
+    timing.total = ToMicros(end - start);
+    owner_->metrics_.record(sql, timing, affected, true);
+    owner_->logStatement(sql, start, end, "affected", affected);
+    return affected;
+  } catch (const sql::SQLException &e) {
+    timing.total = ToMicros(std::chrono::steady_clock::now() - start);
+    owner_->metrics_.record(sql, timing, 0, false);
+    last_error_code_ = e.getErrorCode();
+    std::ostringstream oss;
+    oss << "Update failed in transaction: " << e.what()
+        << " (Error: " << e.getErrorCode() << ")";
+    LOG(ERROR) << oss.str() << " SQL=" << sql;
+    return absl::InternalError(oss.str());
+  }
+}
+
+absl::StatusOr<int64_t> Transaction::lastInsertId() {
+  auto rows = query("SELECT LAST_INSERT_ID() AS ID");
+  if (!rows.ok()) {
+    return rows.status();
+  }
+  if (rows->empty()) {
+    return absl::InternalError("LAST_INSERT_ID() returned no rows");
+  }
+  return rows->front().getInt64("ID");
+}
+
+absl::Status MySqlClient::runInTransaction(
+    const std::function<absl::Status(Transaction &)> &fn) {
+  int attempt = 0;
+  while (true) {
+    int error_code = 0;
+    absl::Status status;
+    try {
+      auto conn = acquireConnection();
+      try {
+        conn->setAutoCommit(false);
+        Transaction tx(this, conn.get());
+        status = fn(tx);
+        error_code = tx.last_error_code_;
+        if (status.ok()) {
+          conn->commit();
+        } else {
+          conn->rollback();
+        }
+        conn->setAutoCommit(true);
+      } catch (const sql::SQLException &e) {
+        // BEGIN/COMMIT/ROLLBACK 本身失败，连接状态未知，直接丢弃
+        // （关闭连接时服务端会回滚未提交的事务）
+        conn.discard();
+        error_code = e.getErrorCode();
+        std::ostringstream oss;
+        oss << "Transaction failed: " << e.what() << " (Error: "
+            << e.getErrorCode() << ")";
+        status = absl::InternalError(oss.str());
+      } catch (...) {
+        conn.discard();
+        throw;
+      }
+    } catch (const std::exception &e) {
+      // 取连接失败或 fn 抛出异常
+      LOG(ERROR) << "Transaction failed: " << e.what();
+      return absl::InternalError(std::string("Transaction failed: ") +
+                                 e.what());
+    }
+
+    if (status.ok() || !IsRetryableTxError(error_code) ||
+        attempt >= cfg_.retry.max_retries) {
+      if (!status.ok()) {
+        LOG(ERROR) << status.message();
+      }
+      return status;
+    }
+
+    const int backoff = cfg_.retry.base_backoff_ms * (1 << attempt);
+    LOG(WARNING) << "Transaction aborted (Error: " << error_code
+                 << "), retrying in " << backoff << "ms";
+    std::this_thread::sleep_for(std::chrono::milliseconds(backoff));
+    ++attempt;
+  }
+}
+
 absl::Status MySqlClient::ping() {
   try {
-    std::lock_guard<std::mutex> lock(connection_mutex_);
-    ensureConnectionUnlocked();
-    std::unique_ptr<sql::Statement> stmt(connection_->createStatement());
-    std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT 1"));
-    res->next(); // Consume result
-    return absl::OkStatus();
+    auto conn = acquireConnection();
+    try {
+      std::unique_ptr<sql::Statement> stmt(conn->createStatement());
+      std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT 1"));
+      res->next(); // Consume result
+      return absl::OkStatus();
+    } catch (const sql::SQLException &) {
+      conn.discard();
+      throw;
+    }
   } catch (const sql::SQLException &e) {
     try {
       reconnect();
-      return absl::OkStatus();
+      // 重连后在新租到的连接上再验证一次
+      auto conn = acquireConnection();
+      try {
+        std::unique_ptr<sql::Statement> stmt(conn->createStatement());
+        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT 1"));
+        res->next();
+        return absl::OkStatus();
+      } catch (const sql::SQLException &) {
+        conn.discard();
+        throw;
+      }
     } catch (...) {
       return absl::InternalError(std::string("Ping failed: ") + e.what());
     }
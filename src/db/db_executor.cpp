@@ -0,0 +1,34 @@
+#include "db/db_executor.h"
+
+#include <glog/logging.h>
+
+namespace db {
+
+namespace {
+constexpr int kDefaultMaxThreads = 4;
+} // namespace
+
+QThreadPool *DbExecutor::Pool() {
+  // 有意不析构：退出时由 MySqlClient::Shutdown 调用 WaitForDone 收尾
+  static QThreadPool *pool = [] {
+    auto *p = new QThreadPool();
+    p->setObjectName(QStringLiteral("DbExecutor"));
+    p->setMaxThreadCount(kDefaultMaxThreads);
+    return p;
+  }();
+  return pool;
+}
+
+void DbExecutor::SetMaxThreads(int max_threads) {
+  if (max_threads < 1) {
+    max_threads = 1;
+  }
+  Pool()->setMaxThreadCount(max_threads);
+  LOG(INFO) << "DbExecutor max threads = " << max_threads;
+}
+
+bool DbExecutor::WaitForDone(int timeout_ms) {
+  return Pool()->waitForDone(timeout_ms);
+}
+
+} // namespace db
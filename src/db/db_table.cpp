@@ -1,11 +1,228 @@
 #include "db/db_table.h"
 
 #include "client/mysql_client.h"
+#include <absl/status/statusor.h>
+#include <absl/strings/str_format.h>
 #include <glog/logging.h>
+#include <algorithm>
 #include <string>
+#include <vector>
 
 namespace db {
 
+namespace {
+
+struct Migration {
+  int version;
+  const char *description;
+  absl::Status (*apply)(MySqlClient *client);
+};
+
+absl::StatusOr<bool> IndexExists(MySqlClient *client, const std::string &table,
+                                 const std::string &index) {
+  auto rows = client->executeQuery(
+      "SELECT COUNT(*) AS Cnt FROM information_schema.STATISTICS "
+      "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ? AND INDEX_NAME = ?",
+      {table, index});
+  if (!rows.ok()) {
+    return rows.status();
+  }
+  return !rows->empty() && rows->front().getInt64("Cnt") > 0;
+}
+
+absl::Status AddIndexIfMissing(MySqlClient *client, const std::string &table,
+                               const std::string &index,
+                               const std::string &columns) {
+  auto exists = IndexExists(client, table, index);
+  if (!exists.ok()) {
+    return exists.status();
+  }
+  if (*exists) {
+    return absl::OkStatus();
+  }
+  return client
+      ->executeUpdate(absl::StrFormat("ALTER TABLE `%s` ADD INDEX `%s` (%s)",
+                                      table, index, columns))
+      .status();
+}
+
+// v1: 覆盖 WHERE EquipNo = ? ORDER BY CreatedAt DESC, ID DESC LIMIT ?
+// 避免历史记录增长后 filesort
+absl::Status MigrateV1EquipTimeIndex(MySqlClient *client) {
+  return AddIndexIfMissing(client, "self_check_record", "idx_equip_ctime_id",
+                           "`EquipNo`, `CreatedAt`, `ID`");
+}
+
+absl::StatusOr<bool> ColumnExists(MySqlClient *client, const std::string &table,
+                                  const std::string &column) {
+  auto rows = client->executeQuery(
+      "SELECT COUNT(*) AS Cnt FROM information_schema.COLUMNS "
+      "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ? AND COLUMN_NAME = ?",
+      {table, column});
+  if (!rows.ok()) {
+    return rows.status();
+  }
+  return !rows->empty() && rows->front().getInt64("Cnt") > 0;
+}
+
+constexpr const char *kFaultSummaryBackfill = "fault_summary";
+
+// 由明细重建日汇总（覆盖而非累加，可重跑）
+absl::Status RebuildDailyRollup(MySqlClient *client) {
+  return client
+      ->executeUpdate(R"(
+    INSERT INTO self_check_daily_rollup
+      (Day, EquipNo, TotalCount, OkCount, WarnCount, ErrorCount,
+       FaultCcuCount, AcContactorFaults, ParallelContactorFaults, FanFaults,
+       GunFaults, FaultMask)
+    SELECT DATE(CreatedAt), EquipNo, COUNT(*),
+           SUM(Status = 'OK'), SUM(Status = 'WARN'), SUM(Status = 'ERROR'),
+           COALESCE(SUM(FaultCcuCount), 0), COALESCE(SUM(AcContactorFaults), 0),
+           COALESCE(SUM(ParallelContactorFaults), 0),
+           COALESCE(SUM(FanFaults), 0), COALESCE(SUM(GunFaults), 0),
+           BIT_OR(COALESCE(FaultMask, 0))
+    FROM self_check_record
+    GROUP BY DATE(CreatedAt), EquipNo
+    ON DUPLICATE KEY UPDATE
+      TotalCount = VALUES(TotalCount), OkCount = VALUES(OkCount),
+      WarnCount = VALUES(WarnCount), ErrorCount = VALUES(ErrorCount),
+      FaultCcuCount = VALUES(FaultCcuCount),
+      AcContactorFaults = VALUES(AcContactorFaults),
+      ParallelContactorFaults = VALUES(ParallelContactorFaults),
+      FanFaults = VALUES(FanFaults), GunFaults = VALUES(GunFaults),
+      FaultMask = VALUES(FaultMask)
+  )")
+      .status();
+}
+
+// 按 ID 区间回填故障摘要列
+std::string BackfillFaultSummarySql() {
+  return "UPDATE self_check_record r JOIN (" +
+         FaultSummarySelectSql("s.ID BETWEEN ? AND ? AND s.CcuCount IS NULL") +
+         R"() agg ON agg.ID = r.ID
+    SET r.CcuCount = agg.CcuCount,
+        r.FaultCcuCount = agg.FaultCcuCount,
+        r.AcContactorFaults = agg.AcFaults,
+        r.ParallelContactorFaults = agg.ParFaults,
+        r.FanFaults = agg.FanFaults,
+        r.GunFaults = agg.GunFaults,
+        r.FaultMask = agg.FaultMask
+  )";
+}
+
+// v2: 故障摘要列，写入时由 device::SummarizeFaults 计算，
+// 列表/看板直接读列，不再解析 DetailsJSON。位号定义见 device/ccu_fault.h
+absl::Status MigrateV2FaultSummaryColumns(MySqlClient *client) {
+  struct Column {
+    const char *name;
+    const char *definition;
+  };
+  static const Column kColumns[] = {
+      {"CcuCount", "SMALLINT UNSIGNED NULL COMMENT 'CCU 数量'"},
+      {"FaultCcuCount",
+       "SMALLINT UNSIGNED NULL COMMENT '存在故障的 CCU 数量'"},
+      {"AcContactorFaults",
+       "SMALLINT UNSIGNED NULL COMMENT '交流接触器故障数'"},
+      {"ParallelContactorFaults",
+       "SMALLINT UNSIGNED NULL COMMENT '并联接触器故障数'"},
+      {"FanFaults", "SMALLINT UNSIGNED NULL COMMENT '风扇停转数'"},
+      {"GunFaults", "SMALLINT UNSIGNED NULL COMMENT '枪接触器故障数'"},
+      {"FaultMask",
+       "INT UNSIGNED NULL COMMENT '各 CCU 故障位按位或（位号=Redis 字段序号）'"},
+  };
+
+  std::string alter;
+  for (const auto &column : kColumns) {
+    auto exists = ColumnExists(client, "self_check_record", column.name);
+    if (!exists.ok()) {
+      return exists.status();
+    }
+    if (*exists) {
+      continue;
+    }
+    alter += alter.empty() ? "ALTER TABLE `self_check_record` " : ", ";
+    alter += absl::StrFormat("ADD COLUMN `%s` %s", column.name,
+                             column.definition);
+  }
+  if (!alter.empty()) {
+    if (auto result = client->executeUpdate(alter); !result.ok()) {
+      return result.status();
+    }
+  }
+
+  // 存量记录不在启动路径上回填（大表上整表 UPDATE 会阻塞启动与设备加载），
+  // 只登记待回填的 ID 区间，由 BackfillFaultSummaryBatch 在后台分批执行
+  auto created = client->executeUpdate(R"(
+    CREATE TABLE IF NOT EXISTS `schema_backfill` (
+        `Name`       VARCHAR(64) NOT NULL COMMENT '回填任务名',
+        `NextId`     BIGINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '下一批起始 ID',
+        `UpperId`    BIGINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '需回填的最大 ID（含）',
+        `FinishedAt` DATETIME NULL COMMENT '完成时间',
+        PRIMARY KEY (`Name`)
+    ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='后台数据回填进度';
+  )");
+  if (!created.ok()) {
+    return created.status();
+  }
+  return client
+      ->executeUpdate(
+          "INSERT IGNORE INTO schema_backfill (Name, NextId, UpperId) "
+          "SELECT ?, COALESCE(MIN(ID), 0), COALESCE(MAX(ID), 0) "
+          "FROM self_check_record",
+          {std::string(kFaultSummaryBackfill)})
+      .status();
+}
+
+// v3: 按 (日期, 设备) 的自检结果日汇总，写入记录时在同一事务内增量累加，
+// 趋势图只需扫描几百行，不再全表扫描 self_check_record
+absl::Status MigrateV3DailyRollup(MySqlClient *client) {
+  auto created = client->executeUpdate(R"(
+    CREATE TABLE IF NOT EXISTS `self_check_daily_rollup` (
+        `Day`                     DATE NOT NULL COMMENT '日期（CreatedAt 所在日）',
+        `EquipNo`                 VARCHAR(64) NOT NULL COMMENT '设备编号',
+        `TotalCount`              INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '自检次数',
+        `OkCount`                 INT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'Status = OK',
+        `WarnCount`               INT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'Status = WARN',
+        `ErrorCount`              INT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'Status = ERROR',
+        `FaultCcuCount`           INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '故障 CCU 数累计',
+        `AcContactorFaults`       INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '交流接触器故障累计',
+        `ParallelContactorFaults` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '并联接触器故障累计',
+        `FanFaults`               INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '风扇停转累计',
+        `GunFaults`               INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '枪接触器故障累计',
+        `FaultMask`               INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '当日出现过的故障位',
+        `UpdatedAt`               DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP COMMENT '更新时间',
+        PRIMARY KEY (`Day`, `EquipNo`),
+        INDEX `idx_equip_day` (`EquipNo`, `Day`)
+    ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='设备自检结果日汇总';
+  )");
+  // 只建表：存量记录的汇总依赖 v2 摘要列，由后台回填完成后统一重建
+  // （见 BackfillFaultSummaryBatch），不在启动路径上做全表聚合
+  return created.status();
+}
+
+// v4: 历史检索仅按状态过滤（如“全部 ERROR 记录”）时按时间倒序取前 N 条
+absl::Status MigrateV4StatusTimeIndex(MySqlClient *client) {
+  return AddIndexIfMissing(client, "self_check_record", "idx_status_ctime",
+                           "`Status`, `CreatedAt`");
+}
+
+// 迁移列表：只追加，不修改已发布的版本
+const std::vector<Migration> &Migrations() {
+  static const std::vector<Migration> kMigrations = {
+      {1, "self_check_record: composite index (EquipNo, CreatedAt, ID)",
+       &MigrateV1EquipTimeIndex},
+      {2, "self_check_record: per-category fault summary columns",
+       &MigrateV2FaultSummaryColumns},
+      {3, "self_check_daily_rollup: per-day outcome rollup",
+       &MigrateV3DailyRollup},
+      {4, "self_check_record: index (Status, CreatedAt) for history search",
+       &MigrateV4StatusTimeIndex},
+  };
+  return kMigrations;
+}
+
+} // namespace
+
 absl::Status CreateSelfCheckRecordTable() {
   auto *client = MySqlClient::GetInstance();
   if (client == nullptr) {
@@ -44,4 +261,196 @@ absl::Status CreateSelfCheckRecordTable() {
   return absl::OkStatus();
 }
 
+absl::Status RunSchemaMigrations() {
+  auto *client = MySqlClient::GetInstance();
+  if (client == nullptr) {
+    return absl::InternalError("MySQL client not initialized");
+  }
+
+  auto created = client->executeUpdate(R"(
+    CREATE TABLE IF NOT EXISTS `schema_version` (
+        `Version`     INT NOT NULL COMMENT '迁移版本号',
+        `Description` VARCHAR(255) NOT NULL DEFAULT '' COMMENT '迁移说明',
+        `AppliedAt`   DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP COMMENT '执行时间',
+        PRIMARY KEY (`Version`)
+    ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='数据库结构版本';
+  )");
+  if (!created.ok()) {
+    LOG(ERROR) << "Failed to create schema_version table: "
+               << created.status().message();
+    return created.status();
+  }
+
+  auto rows = client->executeQuery(
+      "SELECT COALESCE(MAX(Version), 0) AS Version FROM schema_version");
+  if (!rows.ok()) {
+    return rows.status();
+  }
+  const int current = rows->empty() ? 0 : rows->front().getInt("Version");
+  int schema_version = current;
+
+  for (const auto &migration : Migrations()) {
+    if (migration.version <= current) {
+      continue;
+    }
+
+    LOG(INFO) << "Applying schema migration v" << migration.version << ": "
+              << migration.description;
+    if (auto status = migration.apply(client); !status.ok()) {
+      LOG(ERROR) << "Schema migration v" << migration.version
+                 << " failed: " << status.message();
+      return status;
+    }
+
+    auto recorded = client->executeUpdate(
+        "INSERT IGNORE INTO schema_version (Version, Description) "
+        "VALUES (?, ?)",
+        {static_cast<int64_t>(migration.version),
+         std::string(migration.description)});
+    if (!recorded.ok()) {
+      return recorded.status();
+    }
+    schema_version = migration.version;
+  }
+
+  LOG(INFO) << "RunSchemaMigrations: schema at v" << schema_version;
+  return absl::OkStatus();
+}
+
+absl::Status AccumulateDailyRollup(Transaction &tx) {
+  // 从刚插入的行取值，日期与记录的 CreatedAt 严格一致；
+  // CreatedAt 下界让按 ID 的查找只落在最近的分区（行刚插入，必在范围内）
+  return tx
+      .update(R"(
+    INSERT INTO self_check_daily_rollup
+      (Day, EquipNo, TotalCount, OkCount, WarnCount, ErrorCount,
+       FaultCcuCount, AcContactorFaults, ParallelContactorFaults, FanFaults,
+       GunFaults, FaultMask)
+    SELECT DATE(CreatedAt), EquipNo, 1,
+           Status = 'OK', Status = 'WARN', Status = 'ERROR',
+           COALESCE(FaultCcuCount, 0), COALESCE(AcContactorFaults, 0),
+           COALESCE(ParallelContactorFaults, 0), COALESCE(FanFaults, 0),
+           COALESCE(GunFaults, 0), COALESCE(FaultMask, 0)
+    FROM self_check_record
+    WHERE ID = LAST_INSERT_ID()
+      AND CreatedAt >= CURRENT_DATE - INTERVAL 1 DAY
+    ON DUPLICATE KEY UPDATE
+      TotalCount = TotalCount + VALUES(TotalCount),
+      OkCount = OkCount + VALUES(OkCount),
+      WarnCount = WarnCount + VALUES(WarnCount),
+      ErrorCount = ErrorCount + VALUES(ErrorCount),
+      FaultCcuCount = FaultCcuCount + VALUES(FaultCcuCount),
+      AcContactorFaults = AcContactorFaults + VALUES(AcContactorFaults),
+      ParallelContactorFaults =
+        ParallelContactorFaults + VALUES(ParallelContactorFaults),
+      FanFaults = FanFaults + VALUES(FanFaults),
+      GunFaults = GunFaults + VALUES(GunFaults),
+      FaultMask = FaultMask | VALUES(FaultMask)
+  )")
+      .status();
+}
+
+std::string FaultSummarySelectSql(const std::string &where) {
+  // 与 SummarizeFaults 相同的 20 个故障位
+  return R"(
+      SELECT s.ID,
+             COUNT(jt.ord) AS CcuCount,
+             COALESCE(SUM(jt.ac1r OR jt.ac1s OR jt.ac2r OR jt.ac2s OR
+                          jt.ppr OR jt.pps OR jt.pnr OR jt.pns OR
+                          jt.f1 OR jt.f2 OR jt.f3 OR jt.f4 OR
+                          jt.apr OR jt.aps OR jt.anr OR jt.ans OR
+                          jt.bpr OR jt.bps OR jt.bnr OR jt.bns), 0) AS FaultCcuCount,
+             COALESCE(SUM(jt.ac1r + jt.ac1s + jt.ac2r + jt.ac2s), 0) AS AcFaults,
+             COALESCE(SUM(jt.ppr + jt.pps + jt.pnr + jt.pns), 0) AS ParFaults,
+             COALESCE(SUM(jt.f1 + jt.f2 + jt.f3 + jt.f4), 0) AS FanFaults,
+             COALESCE(SUM(jt.apr + jt.aps + jt.anr + jt.ans +
+                          jt.bpr + jt.bps + jt.bnr + jt.bns), 0) AS GunFaults,
+             COALESCE(BIT_OR(
+               (jt.ac1r << 0) | (jt.ac1s << 1) | (jt.ac2r << 2) | (jt.ac2s << 3) |
+               (jt.ppr << 4) | (jt.pps << 5) | (jt.pnr << 6) | (jt.pns << 7) |
+               (jt.f1 << 8) | (jt.f2 << 10) | (jt.f3 << 12) | (jt.f4 << 14) |
+               (jt.apr << 16) | (jt.aps << 17) | (jt.anr << 18) | (jt.ans << 19) |
+               (jt.bpr << 24) | (jt.bps << 25) | (jt.bnr << 26) | (jt.bns << 27)
+             ), 0) AS FaultMask
+      FROM self_check_record s
+      LEFT JOIN JSON_TABLE(s.DetailsJSON, '$.ccuModules[*]' COLUMNS (
+        ord FOR ORDINALITY,
+        ac1r BOOLEAN PATH '$.acContactor1.refuse' DEFAULT '0' ON EMPTY,
+        ac1s BOOLEAN PATH '$.acContactor1.stuck' DEFAULT '0' ON EMPTY,
+        ac2r BOOLEAN PATH '$.acContactor2.refuse' DEFAULT '0' ON EMPTY,
+        ac2s BOOLEAN PATH '$.acContactor2.stuck' DEFAULT '0' ON EMPTY,
+        ppr BOOLEAN PATH '$.parallelContactor.positiveRefuse' DEFAULT '0' ON EMPTY,
+        pps BOOLEAN PATH '$.parallelContactor.positiveStuck' DEFAULT '0' ON EMPTY,
+        pnr BOOLEAN PATH '$.parallelContactor.negativeRefuse' DEFAULT '0' ON EMPTY,
+        pns BOOLEAN PATH '$.parallelContactor.negativeStuck' DEFAULT '0' ON EMPTY,
+        f1 BOOLEAN PATH '$.fan1.stopped' DEFAULT '0' ON EMPTY,
+        f2 BOOLEAN PATH '$.fan2.stopped' DEFAULT '0' ON EMPTY,
+        f3 BOOLEAN PATH '$.fan3.stopped' DEFAULT '0' ON EMPTY,
+        f4 BOOLEAN PATH '$.fan4.stopped' DEFAULT '0' ON EMPTY,
+        apr BOOLEAN PATH '$.gunA.positiveContactorRefuse' DEFAULT '0' ON EMPTY,
+        aps BOOLEAN PATH '$.gunA.positiveContactorStuck' DEFAULT '0' ON EMPTY,
+        anr BOOLEAN PATH '$.gunA.negativeContactorRefuse' DEFAULT '0' ON EMPTY,
+        ans BOOLEAN PATH '$.gunA.negativeContactorStuck' DEFAULT '0' ON EMPTY,
+        bpr BOOLEAN PATH '$.gunB.positiveContactorRefuse' DEFAULT '0' ON EMPTY,
+        bps BOOLEAN PATH '$.gunB.positiveContactorStuck' DEFAULT '0' ON EMPTY,
+        bnr BOOLEAN PATH '$.gunB.negativeContactorRefuse' DEFAULT '0' ON EMPTY,
+        bns BOOLEAN PATH '$.gunB.negativeContactorStuck' DEFAULT '0' ON EMPTY
+      )) AS jt ON TRUE
+      WHERE )" +
+         where + " GROUP BY s.ID";
+}
+
+absl::StatusOr<bool> BackfillFaultSummaryBatch(int batch_size) {
+  auto *client = MySqlClient::GetInstance();
+  if (client == nullptr) {
+    return absl::InternalError("MySQL client not initialized");
+  }
+
+  auto progress = client->executeQuery(
+      "SELECT NextId, UpperId FROM schema_backfill "
+      "WHERE Name = ? AND FinishedAt IS NULL",
+      {std::string(kFaultSummaryBackfill)});
+  if (!progress.ok()) {
+    return progress.status();
+  }
+  if (progress->empty()) {
+    return false;
+  }
+  const int64_t next = progress->front().getInt64("NextId");
+  const int64_t upper = progress->front().getInt64("UpperId");
+
+  if (next <= upper) {
+    const int64_t last = std::min(upper, next + std::max(batch_size, 1) - 1);
+    auto updated =
+        client->executeUpdate(BackfillFaultSummarySql(), {next, last});
+    if (!updated.ok()) {
+      return updated.status();
+    }
+    // 多个实例并发回填时只前进、不回退
+    auto advanced = client->executeUpdate(
+        "UPDATE schema_backfill SET NextId = ? WHERE Name = ? AND NextId < ?",
+        {last + 1, std::string(kFaultSummaryBackfill), last + 1});
+    if (!advanced.ok()) {
+      return advanced.status();
+    }
+    VLOG(1) << "BackfillFaultSummaryBatch: IDs " << next << ".." << last
+            << ", updated " << *updated;
+    return true;
+  }
+
+  // 全部回填完成后由明细重建全部历史的日汇总（v3 只建表，不在启动路径上聚合）
+  if (auto status = RebuildDailyRollup(client); !status.ok()) {
+    return status;
+  }
+  auto finished = client->executeUpdate(
+      "UPDATE schema_backfill SET FinishedAt = CURRENT_TIMESTAMP "
+      "WHERE Name = ?",
+      {std::string(kFaultSummaryBackfill)});
+  if (!finished.ok()) {
+    return finished.status();
+  }
+  LOG(INFO) << "BackfillFaultSummaryBatch: fault summary backfill finished";
+  return false;
+}
+
 } // namespace db
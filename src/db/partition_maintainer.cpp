@@ -0,0 +1,457 @@
+#include "db/partition_maintainer.h"
+
+#include "client/mysql_client.h"
+#include "db/query_metrics.h"
+
+#include <absl/status/statusor.h>
+#include <absl/strings/str_format.h>
+#include <absl/strings/str_join.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace db {
+
+namespace {
+
+constexpr const char *kTable = "self_check_record";
+constexpr const char *kArchiveTable = "self_check_record_archive";
+constexpr const char *kMaxPartition = "pmax";
+
+// 分区按自然月划分，命名 pYYYYMM
+struct YearMonth {
+  int year = 0;
+  int month = 0; // 1~12
+
+  // "YYYY-MM"
+  static std::optional<YearMonth> Parse(const std::string &text) {
+    YearMonth ym;
+    if (std::sscanf(text.c_str(), "%4d-%2d", &ym.year, &ym.month) != 2 ||
+        ym.month < 1 || ym.month > 12) {
+      return std::nullopt;
+    }
+    return ym;
+  }
+
+  // "pYYYYMM"
+  static std::optional<YearMonth> FromPartitionName(const std::string &name) {
+    YearMonth ym;
+    if (name.size() != 7 || name[0] != 'p' ||
+        std::sscanf(name.c_str(), "p%4d%2d", &ym.year, &ym.month) != 2 ||
+        ym.month < 1 || ym.month > 12) {
+      return std::nullopt;
+    }
+    return ym;
+  }
+
+  YearMonth plus(int months) const {
+    const int total = year * 12 + (month - 1) + months;
+    return YearMonth{total / 12, total % 12 + 1};
+  }
+
+  std::string partitionName() const {
+    return absl::StrFormat("p%04d%02d", year, month);
+  }
+
+  std::string firstDay() const {
+    return absl::StrFormat("%04d-%02d-01", year, month);
+  }
+
+  // 该月分区的定义：上界为下月 1 日
+  std::string definition() const {
+    return absl::StrFormat("PARTITION %s VALUES LESS THAN (TO_DAYS('%s'))",
+                           partitionName(), plus(1).firstDay());
+  }
+
+  int key() const { return year * 12 + month - 1; }
+  bool operator<(const YearMonth &other) const { return key() < other.key(); }
+  bool operator==(const YearMonth &other) const {
+    return key() == other.key();
+  }
+};
+
+// 按分区顺序返回分区名；未分区返回空
+absl::StatusOr<std::vector<std::string>>
+ListPartitions(MySqlClient *client, const std::string &table) {
+  auto rows = client->executeQuery(
+      "SELECT PARTITION_NAME FROM information_schema.PARTITIONS "
+      "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ? "
+      "AND PARTITION_NAME IS NOT NULL "
+      "ORDER BY PARTITION_ORDINAL_POSITION",
+      {table});
+  if (!rows.ok()) {
+    return rows.status();
+  }
+  std::vector<std::string> names;
+  names.reserve(rows->size());
+  for (const auto &row : *rows) {
+    names.push_back(row.getString("PARTITION_NAME"));
+  }
+  return names;
+}
+
+// 以服务器时间为准，避免客户端时钟/时区与 CreatedAt 不一致
+absl::StatusOr<YearMonth> ServerMonth(MySqlClient *client) {
+  auto rows = client->executeQuery(
+      "SELECT DATE_FORMAT(CURRENT_DATE, '%Y-%m') AS Ym");
+  if (!rows.ok()) {
+    return rows.status();
+  }
+  if (rows->empty()) {
+    return absl::InternalError("CURRENT_DATE returned no rows");
+  }
+  auto ym = YearMonth::Parse(rows->front().getString("Ym"));
+  if (!ym) {
+    return absl::InternalError("unexpected CURRENT_DATE format");
+  }
+  return *ym;
+}
+
+} // namespace
+
+MaintenanceConfig MaintenanceConfig::FromYaml(const YAML::Node &node) {
+  MaintenanceConfig cfg;
+  if (!node) {
+    return cfg;
+  }
+  if (node["enabled"])
+    cfg.enabled = node["enabled"].as<bool>();
+  if (node["convert_table"])
+    cfg.convert_table = node["convert_table"].as<bool>();
+  if (node["retention_months"])
+    cfg.retention_months = node["retention_months"].as<int>();
+  if (node["archive"])
+    cfg.archive = node["archive"].as<bool>();
+  if (node["future_partitions"])
+    cfg.future_partitions = node["future_partitions"].as<int>();
+  if (node["interval_hours"])
+    cfg.interval_hours = node["interval_hours"].as<int>();
+  if (node["initial_delay_sec"])
+    cfg.initial_delay_sec = node["initial_delay_sec"].as<int>();
+
+  cfg.future_partitions = std::max(cfg.future_partitions, 1);
+  cfg.interval_hours = std::max(cfg.interval_hours, 1);
+  return cfg;
+}
+
+std::unique_ptr<PartitionMaintainer> PartitionMaintainer::instance_;
+std::mutex PartitionMaintainer::instance_mutex_;
+
+void PartitionMaintainer::Init(const MaintenanceConfig &cfg) {
+  std::lock_guard<std::mutex> lock(instance_mutex_);
+  if (!instance_) {
+    instance_.reset(new PartitionMaintainer(cfg));
+  }
+}
+
+void PartitionMaintainer::Shutdown() {
+  std::lock_guard<std::mutex> lock(instance_mutex_);
+  instance_.reset();
+}
+
+PartitionMaintainer *PartitionMaintainer::GetInstance() {
+  std::lock_guard<std::mutex> lock(instance_mutex_);
+  return instance_.get();
+}
+
+PartitionMaintainer::PartitionMaintainer(const MaintenanceConfig &cfg)
+    : cfg_(cfg) {
+  if (!cfg_.enabled) {
+    LOG(INFO) << "PartitionMaintainer disabled";
+    return;
+  }
+  thread_ = QThread::create([this]() { loop(); });
+  thread_->setObjectName(QStringLiteral("PartitionMaintainer"));
+  thread_->start(QThread::LowestPriority);
+}
+
+PartitionMaintainer::~PartitionMaintainer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  if (thread_ != nullptr) {
+    // 正在执行的 ALTER 无法中断，只能等待其完成
+    thread_->wait();
+    delete thread_;
+    thread_ = nullptr;
+  }
+}
+
+void PartitionMaintainer::loop() {
+  const auto stopped = [this]() { return stopping_; };
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (cv_.wait_for(lock, std::chrono::seconds(cfg_.initial_delay_sec),
+                   stopped)) {
+    return;
+  }
+
+  while (true) {
+    lock.unlock();
+    const auto start = std::chrono::steady_clock::now();
+    if (auto status = runOnce(); !status.ok()) {
+      LOG(ERROR) << "Partition maintenance failed: " << status.message();
+    } else {
+      LOG(INFO) << "Partition maintenance done in "
+                << std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count()
+                << "ms";
+    }
+    lock.lock();
+
+    if (cv_.wait_for(lock, std::chrono::hours(cfg_.interval_hours),
+                     stopped)) {
+      return;
+    }
+  }
+}
+
+absl::Status PartitionMaintainer::runOnce() {
+  ScopedQueryOrigin origin("PartitionMaintainer");
+  auto *client = MySqlClient::GetInstance();
+  if (client == nullptr) {
+    return absl::InternalError("MySQL client not initialized");
+  }
+
+  if (auto status = ensurePartitioned(client); !status.ok()) {
+    return status;
+  }
+  if (auto status = ensureFuturePartitions(client); !status.ok()) {
+    return status;
+  }
+  return enforceRetention(client);
+}
+
+absl::Status PartitionMaintainer::ensurePartitioned(MySqlClient *client) {
+  auto partitions = ListPartitions(client, kTable);
+  if (!partitions.ok()) {
+    return partitions.status();
+  }
+  if (!partitions->empty()) {
+    return absl::OkStatus();
+  }
+  if (!cfg_.convert_table) {
+    // 转换会修改主键并重建整表，必须显式开启或按 doc/db.md 手动迁移；
+    // 未分区时后续的预建与清理都会跳过
+    LOG(WARNING) << kTable << " is not partitioned and convert_table is off; "
+                 << "see doc/db.md for the one-time migration";
+    return absl::OkStatus();
+  }
+
+  auto current = ServerMonth(client);
+  if (!current.ok()) {
+    return current.status();
+  }
+
+  auto min_rows = client->executeQuery(absl::StrFormat(
+      "SELECT DATE_FORMAT(MIN(CreatedAt), '%%Y-%%m') AS Ym FROM %s", kTable));
+  if (!min_rows.ok()) {
+    return min_rows.status();
+  }
+  YearMonth first = *current;
+  if (!min_rows->empty()) {
+    if (auto ym = YearMonth::Parse(min_rows->front().getString("Ym"))) {
+      first = std::min(first, *ym);
+    }
+  }
+  const YearMonth last = current->plus(cfg_.future_partitions);
+
+  LOG(WARNING) << "Converting " << kTable << " to monthly partitions "
+               << first.partitionName() << ".." << last.partitionName()
+               << "; the table is rebuilt and writes block until done";
+
+  // 分区表的每个唯一键都必须包含分区列
+  auto pk_rows = client->executeQuery(
+      "SELECT COUNT(*) AS Cnt FROM information_schema.KEY_COLUMN_USAGE "
+      "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ? "
+      "AND CONSTRAINT_NAME = 'PRIMARY' AND COLUMN_NAME = 'CreatedAt'",
+      {std::string(kTable)});
+  if (!pk_rows.ok()) {
+    return pk_rows.status();
+  }
+  if (pk_rows->empty() || pk_rows->front().getInt64("Cnt") == 0) {
+    auto altered = client->executeUpdate(absl::StrFormat(
+        "ALTER TABLE `%s` DROP PRIMARY KEY, ADD PRIMARY KEY (`ID`, `CreatedAt`)",
+        kTable));
+    if (!altered.ok()) {
+      return altered.status();
+    }
+  }
+
+  std::vector<std::string> definitions;
+  for (YearMonth ym = first; !(last < ym); ym = ym.plus(1)) {
+    definitions.push_back(ym.definition());
+  }
+  definitions.push_back(absl::StrFormat(
+      "PARTITION %s VALUES LESS THAN MAXVALUE", kMaxPartition));
+
+  auto partitioned = client->executeUpdate(absl::StrFormat(
+      "ALTER TABLE `%s` PARTITION BY RANGE (TO_DAYS(`CreatedAt`)) (%s)",
+      kTable, absl::StrJoin(definitions, ", ")));
+  if (!partitioned.ok()) {
+    return partitioned.status();
+  }
+
+  LOG(INFO) << kTable << " partitioned into " << definitions.size()
+            << " partitions";
+  return absl::OkStatus();
+}
+
+absl::Status PartitionMaintainer::ensureFuturePartitions(MySqlClient *client) {
+  auto partitions = ListPartitions(client, kTable);
+  if (!partitions.ok()) {
+    return partitions.status();
+  }
+  if (partitions->empty()) {
+    return absl::OkStatus();
+  }
+
+  std::optional<YearMonth> newest;
+  bool has_max = false;
+  for (const auto &name : *partitions) {
+    if (name == kMaxPartition) {
+      has_max = true;
+    } else if (auto ym = YearMonth::FromPartitionName(name)) {
+      newest = newest ? std::max(*newest, *ym) : *ym;
+    }
+  }
+
+  auto current = ServerMonth(client);
+  if (!current.ok()) {
+    return current.status();
+  }
+
+  // 只能在已有最新分区之后追加
+  const YearMonth target = current->plus(cfg_.future_partitions);
+  YearMonth next = newest ? newest->plus(1) : *current;
+  std::vector<std::string> definitions;
+  for (; !(target < next); next = next.plus(1)) {
+    definitions.push_back(next.definition());
+  }
+  if (definitions.empty()) {
+    return absl::OkStatus();
+  }
+
+  std::string sql;
+  if (has_max) {
+    // pmax 正常情况下为空，拆分几乎无数据移动
+    definitions.push_back(absl::StrFormat(
+        "PARTITION %s VALUES LESS THAN MAXVALUE", kMaxPartition));
+    sql = absl::StrFormat("ALTER TABLE `%s` REORGANIZE PARTITION %s INTO (%s)",
+                          kTable, kMaxPartition,
+                          absl::StrJoin(definitions, ", "));
+  } else {
+    sql = absl::StrFormat("ALTER TABLE `%s` ADD PARTITION (%s)", kTable,
+                          absl::StrJoin(definitions, ", "));
+  }
+
+  auto result = client->executeUpdate(sql);
+  if (!result.ok()) {
+    return result.status();
+  }
+  LOG(INFO) << "Created " << (has_max ? definitions.size() - 1
+                                      : definitions.size())
+            << " future partitions up to " << target.partitionName();
+  return absl::OkStatus();
+}
+
+absl::Status PartitionMaintainer::ensureArchiveTable(MySqlClient *client) {
+  auto created = client->executeUpdate(absl::StrFormat(
+      "CREATE TABLE IF NOT EXISTS `%s` LIKE `%s`", kArchiveTable, kTable));
+  if (!created.ok()) {
+    return created.status();
+  }
+
+  // LIKE 会复制分区定义，归档表不需要分区
+  auto partitions = ListPartitions(client, kArchiveTable);
+  if (!partitions.ok()) {
+    return partitions.status();
+  }
+  if (!partitions->empty()) {
+    auto removed = client->executeUpdate(
+        absl::StrFormat("ALTER TABLE `%s` REMOVE PARTITIONING", kArchiveTable));
+    if (!removed.ok()) {
+      return removed.status();
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status PartitionMaintainer::enforceRetention(MySqlClient *client) {
+  if (cfg_.retention_months <= 0) {
+    return absl::OkStatus();
+  }
+
+  auto partitions = ListPartitions(client, kTable);
+  if (!partitions.ok()) {
+    return partitions.status();
+  }
+  auto current = ServerMonth(client);
+  if (!current.ok()) {
+    return current.status();
+  }
+
+  const YearMonth oldest_kept = current->plus(1 - cfg_.retention_months);
+  std::vector<std::string> expired;
+  for (const auto &name : *partitions) {
+    auto ym = YearMonth::FromPartitionName(name);
+    if (ym && *ym < oldest_kept) {
+      expired.push_back(name);
+    }
+  }
+  if (expired.empty()) {
+    return absl::OkStatus();
+  }
+
+  std::string columns;
+  if (cfg_.archive) {
+    if (auto status = ensureArchiveTable(client); !status.ok()) {
+      return status;
+    }
+    // 以归档表的列为准：主表后续新增的列不会导致归档失败
+    auto rows = client->executeQuery(
+        "SELECT COLUMN_NAME FROM information_schema.COLUMNS "
+        "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ? "
+        "ORDER BY ORDINAL_POSITION",
+        {std::string(kArchiveTable)});
+    if (!rows.ok()) {
+      return rows.status();
+    }
+    std::vector<std::string> names;
+    for (const auto &row : *rows) {
+      names.push_back("`" + row.getString("COLUMN_NAME") + "`");
+    }
+    columns = absl::StrJoin(names, ", ");
+  }
+
+  for (const auto &name : expired) {
+    if (cfg_.archive) {
+      // INSERT IGNORE：归档后、删除前中断时重跑不会重复
+      auto archived = client->executeUpdate(absl::StrFormat(
+          "INSERT IGNORE INTO `%s` (%s) SELECT %s FROM `%s` PARTITION (%s)",
+          kArchiveTable, columns, columns, kTable, name));
+      if (!archived.ok()) {
+        return archived.status();
+      }
+      LOG(INFO) << "Archived " << *archived << " rows from partition " << name;
+    }
+
+    auto dropped = client->executeUpdate(
+        absl::StrFormat("ALTER TABLE `%s` DROP PARTITION %s", kTable, name));
+    if (!dropped.ok()) {
+      return dropped.status();
+    }
+    LOG(INFO) << "Dropped expired partition " << name;
+  }
+  return absl::OkStatus();
+}
+
+} // namespace db
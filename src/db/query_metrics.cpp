@@ -0,0 +1,253 @@
+#include "db/query_metrics.h"
+
+#include <absl/strings/str_format.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <sstream>
+
+namespace db {
+
+namespace {
+
+constexpr std::size_t kMaxFingerprintLength = 512;
+
+thread_local const char *t_query_origin = nullptr;
+
+int HighestBit(std::uint64_t value) { return 63 - __builtin_clzll(value); }
+
+double UsToMs(std::uint64_t us) { return static_cast<double>(us) / 1000.0; }
+
+bool IsIdentChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+}
+
+// 输出一个占位符；若前面紧跟 "?," 则折叠为 "?+"
+void AppendPlaceholder(std::string &out) {
+  std::size_t end = out.size();
+  while (end > 0 && out[end - 1] == ' ')
+    --end;
+  if (end > 0 && out[end - 1] == ',') {
+    std::size_t prev = end - 1;
+    while (prev > 0 && out[prev - 1] == ' ')
+      --prev;
+    if (prev > 0 && (out[prev - 1] == '?' || out[prev - 1] == '+')) {
+      out.resize(prev);
+      if (out.back() != '+')
+        out.push_back('+');
+      return;
+    }
+  }
+  out.push_back('?');
+}
+
+} // namespace
+
+// ---------------------------
+// LatencyHistogram
+// ---------------------------
+int LatencyHistogram::bucketIndex(std::uint64_t value) {
+  if (value < 2 * kSubBucketCount)
+    return static_cast<int>(value);
+  const int shift = HighestBit(value) - kSubBucketBits;
+  return kSubBucketCount * shift + static_cast<int>(value >> shift);
+}
+
+std::uint64_t LatencyHistogram::bucketLowerBound(int index) {
+  if (index < 2 * kSubBucketCount)
+    return static_cast<std::uint64_t>(index);
+  const int shift = index / kSubBucketCount - 1;
+  const auto top = static_cast<std::uint64_t>(index - kSubBucketCount * shift);
+  return top << shift;
+}
+
+void LatencyHistogram::record(std::uint64_t value_us) {
+  constexpr std::uint64_t kMaxValue = (std::uint64_t{1} << kMaxValueBits) - 1;
+  value_us = std::min(value_us, kMaxValue);
+  ++counts_[bucketIndex(value_us)];
+  ++total_count_;
+  sum_ += value_us;
+  max_ = std::max(max_, value_us);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+  for (int i = 0; i < kBucketCount; ++i)
+    counts_[i] += other.counts_[i];
+  total_count_ += other.total_count_;
+  sum_ += other.sum_;
+  max_ = std::max(max_, other.max_);
+}
+
+std::uint64_t LatencyHistogram::percentile(double p) const {
+  if (total_count_ == 0)
+    return 0;
+  p = std::clamp(p, 0.0, 100.0);
+  auto rank = static_cast<std::uint64_t>(
+      std::ceil(p / 100.0 * static_cast<double>(total_count_)));
+  rank = std::max<std::uint64_t>(rank, 1);
+
+  std::uint64_t seen = 0;
+  for (int i = 0; i < kBucketCount; ++i) {
+    seen += counts_[i];
+    if (seen >= rank) {
+      const std::uint64_t upper = i + 1 < kBucketCount
+                                      ? bucketLowerBound(i + 1) - 1
+                                      : bucketLowerBound(i);
+      return std::min(upper, max_);
+    }
+  }
+  return max_;
+}
+
+// ---------------------------
+// QueryMetrics
+// ---------------------------
+std::string QueryMetrics::Fingerprint(std::string_view sql) {
+  std::string out;
+  out.reserve(std::min(sql.size(), kMaxFingerprintLength));
+
+  std::size_t i = 0;
+  while (i < sql.size() && out.size() < kMaxFingerprintLength) {
+    const char c = sql[i];
+
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      while (i < sql.size() && std::isspace(static_cast<unsigned char>(sql[i])))
+        ++i;
+      if (!out.empty() && out.back() != ' ')
+        out.push_back(' ');
+      continue;
+    }
+
+    // 字符串字面量
+    if (c == '\'' || c == '"') {
+      ++i;
+      while (i < sql.size() && sql[i] != c) {
+        if (sql[i] == '\\')
+          ++i;
+        ++i;
+      }
+      ++i; // closing quote
+      AppendPlaceholder(out);
+      continue;
+    }
+
+    // 数字字面量（不属于标识符的一部分）
+    if (std::isdigit(static_cast<unsigned char>(c)) &&
+        (out.empty() || !IsIdentChar(out.back()))) {
+      while (i < sql.size() &&
+             (IsIdentChar(sql[i]) || sql[i] == '.'))
+        ++i;
+      AppendPlaceholder(out);
+      continue;
+    }
+
+    if (c == '?') {
+      ++i;
+      AppendPlaceholder(out);
+      continue;
+    }
+
+    out.push_back(c);
+    ++i;
+  }
+
+  while (!out.empty() && (out.back() == ' ' || out.back() == ';'))
+    out.pop_back();
+  return out;
+}
+
+void QueryMetrics::record(std::string_view sql, const QueryTiming &timing,
+                          std::uint64_t rows, bool ok) {
+  const char *origin = ScopedQueryOrigin::Current();
+  std::string fingerprint = Fingerprint(sql);
+  std::string key = origin != nullptr ? origin : "";
+  key.push_back('|');
+  key.append(fingerprint);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto [it, inserted] = stats_.try_emplace(std::move(key));
+  auto &stats = it->second;
+  if (inserted) {
+    stats.origin = origin != nullptr ? origin : "";
+    stats.fingerprint = std::move(fingerprint);
+  }
+
+  ++stats.count;
+  if (!ok)
+    ++stats.errors;
+  stats.rows += rows;
+  stats.latency.record(timing.total.count());
+  stats.acquire_wait.record(timing.acquire_wait.count());
+  stats.prepare.record(timing.prepare.count());
+  stats.fetch.record(timing.fetch.count());
+}
+
+std::vector<StatementSnapshot> QueryMetrics::snapshot() const {
+  std::vector<StatementSnapshot> out;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    out.reserve(stats_.size());
+    for (const auto &[key, stats] : stats_) {
+      StatementSnapshot snap;
+      snap.origin = stats.origin;
+      snap.fingerprint = stats.fingerprint;
+      snap.count = stats.count;
+      snap.errors = stats.errors;
+      snap.rows = stats.rows;
+      snap.total_ms = UsToMs(stats.latency.sum());
+      snap.p50_ms = UsToMs(stats.latency.percentile(50));
+      snap.p95_ms = UsToMs(stats.latency.percentile(95));
+      snap.p99_ms = UsToMs(stats.latency.percentile(99));
+      snap.max_ms = UsToMs(stats.latency.max());
+      snap.acquire_p95_ms = UsToMs(stats.acquire_wait.percentile(95));
+      snap.prepare_p95_ms = UsToMs(stats.prepare.percentile(95));
+      snap.fetch_p95_ms = UsToMs(stats.fetch.percentile(95));
+      out.push_back(std::move(snap));
+    }
+  }
+
+  std::sort(out.begin(), out.end(),
+            [](const StatementSnapshot &a, const StatementSnapshot &b) {
+              return a.total_ms > b.total_ms;
+            });
+  return out;
+}
+
+std::string QueryMetrics::report(std::size_t top_n) const {
+  const auto snaps = snapshot();
+  std::ostringstream oss;
+  oss << "SQL metrics (" << snaps.size() << " statements, top " << top_n
+      << " by total time):";
+  for (std::size_t i = 0; i < snaps.size() && i < top_n; ++i) {
+    const auto &s = snaps[i];
+    oss << "\n  "
+        << absl::StrFormat(
+               "[%s] n=%d err=%d rows=%d total=%.1fms p50=%.2f p95=%.2f "
+               "p99=%.2f max=%.2f acq95=%.2f prep95=%.2f fetch95=%.2f | %s",
+               s.origin.empty() ? "-" : s.origin, s.count, s.errors, s.rows,
+               s.total_ms, s.p50_ms, s.p95_ms, s.p99_ms, s.max_ms,
+               s.acquire_p95_ms, s.prepare_p95_ms, s.fetch_p95_ms,
+               s.fingerprint);
+  }
+  return oss.str();
+}
+
+void QueryMetrics::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.clear();
+}
+
+// ---------------------------
+// ScopedQueryOrigin
+// ---------------------------
+ScopedQueryOrigin::ScopedQueryOrigin(const char *origin)
+    : previous_(t_query_origin) {
+  t_query_origin = origin;
+}
+
+ScopedQueryOrigin::~ScopedQueryOrigin() { t_query_origin = previous_; }
+
+const char *ScopedQueryOrigin::Current() { return t_query_origin; }
+
+} // namespace db
@@ -0,0 +1,43 @@
+#include "device/ccu_codec.h"
+#include "device/ccu_fields.h"
+
+#include <nlohmann/json.hpp>
+#include <string>
+
+namespace device {
+
+nlohmann::json EncodeCcuModule(const CCUAttributes &attrs) {
+  nlohmann::json module_json; // NOLINT
+  module_json["index"] = attrs.index;
+  ForEachCcuField([&](const CcuFieldDesc &field) {
+    module_json[std::string(field.json_group)][std::string(field.json_key)] =
+        field.get(attrs);
+  });
+  return module_json;
+}
+
+CCUAttributes DecodeCcuModule(const nlohmann::json &module) {
+  CCUAttributes attrs;
+  attrs.index = module.value("index", 0);
+
+  // 同一模块对象的字段在表中相邻，只在分组切换时查找一次
+  std::string_view current_group;
+  const nlohmann::json *group = nullptr;
+  ForEachCcuField([&](const CcuFieldDesc &field) {
+    if (field.json_group != current_group) {
+      current_group = field.json_group;
+      auto it = module.find(std::string(field.json_group));
+      group = (it != module.end() && it->is_object()) ? &*it : nullptr;
+    }
+    if (group == nullptr) {
+      return;
+    }
+    auto it = group->find(std::string(field.json_key));
+    if (it != group->end() && it->is_boolean()) {
+      field.set(attrs, it->get<bool>());
+    }
+  });
+  return attrs;
+}
+
+} // namespace device
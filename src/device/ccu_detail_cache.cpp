@@ -0,0 +1,154 @@
+#include "device/ccu_detail_cache.h"
+
+#include <absl/strings/str_format.h>
+
+namespace device {
+
+CcuDetailCache &CcuDetailCache::Instance() {
+  static CcuDetailCache cache;
+  return cache;
+}
+
+CcuDetailCache::CcuDetailCache(std::size_t capacity_bytes)
+    : capacity_bytes_(capacity_bytes) {}
+
+CcuDetailsPtr CcuDetailCache::get(std::int64_t record_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(record_id);
+  if (it == index_.end()) {
+    ++misses_;
+    return nullptr;
+  }
+  ++hits_;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->details;
+}
+
+bool CcuDetailCache::contains(std::int64_t record_id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return index_.find(record_id) != index_.end();
+}
+
+void CcuDetailCache::put(std::int64_t record_id, CcuDetailsPtr details) {
+  if (details == nullptr) {
+    return;
+  }
+  const std::size_t bytes = EstimateBytes(*details);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (bytes > capacity_bytes_) {
+    // 单条超过上限，不缓存
+    return;
+  }
+
+  auto it = index_.find(record_id);
+  if (it != index_.end()) {
+    bytes_ -= it->second->bytes;
+    it->second->details = std::move(details);
+    it->second->bytes = bytes;
+    lru_.splice(lru_.begin(), lru_, it->second);
+  } else {
+    lru_.push_front(Entry{record_id, std::move(details), bytes});
+    index_.emplace(record_id, lru_.begin());
+  }
+  bytes_ += bytes;
+  evictLocked();
+}
+
+std::optional<std::int64_t>
+CcuDetailCache::latestRecordId(const std::string &equip_no,
+                               std::uint64_t *epoch) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto &latest = latest_[equip_no];
+  if (epoch != nullptr) {
+    *epoch = latest.epoch;
+  }
+  return latest.record_id;
+}
+
+void CcuDetailCache::setLatestRecordId(const std::string &equip_no,
+                                       std::int64_t record_id,
+                                       std::uint64_t epoch) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto &latest = latest_[equip_no];
+  if (latest.epoch != epoch) {
+    // 查询期间已写入新记录
+    return;
+  }
+  latest.record_id = record_id;
+}
+
+void CcuDetailCache::invalidateLatest(const std::string &equip_no) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto &latest = latest_[equip_no];
+  latest.record_id.reset();
+  ++latest.epoch;
+}
+
+void CcuDetailCache::setCapacityBytes(std::size_t capacity_bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  capacity_bytes_ = capacity_bytes;
+  evictLocked();
+}
+
+void CcuDetailCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  lru_.clear();
+  index_.clear();
+  for (auto &[equip_no, latest] : latest_) {
+    latest.record_id.reset();
+    ++latest.epoch;
+  }
+  bytes_ = 0;
+}
+
+CcuDetailCacheStats CcuDetailCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  CcuDetailCacheStats stats;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.evictions = evictions_;
+  stats.entries = index_.size();
+  stats.bytes = bytes_;
+  stats.capacity_bytes = capacity_bytes_;
+  return stats;
+}
+
+std::string CcuDetailCache::report() const {
+  const auto s = stats();
+  return absl::StrFormat(
+      "CcuDetailCache: entries=%d bytes=%d/%d hits=%d misses=%d "
+      "hit_rate=%.1f%% evictions=%d",
+      s.entries, s.bytes, s.capacity_bytes, s.hits, s.misses,
+      s.hitRate() * 100.0, s.evictions);
+}
+
+std::size_t CcuDetailCache::EstimateBytes(const CcuDetails &details) {
+  std::size_t bytes = sizeof(CcuDetails) + sizeof(Entry) +
+                      details.capacity() * sizeof(CCUAttributes);
+  // 元信息按记录共享，只计一次；超出 SSO 的字符串按 capacity 粗略估算
+  const CcuRecordMeta *counted = nullptr;
+  for (const auto &ccu : details) {
+    if (!ccu.meta || ccu.meta.get() == counted) {
+      continue;
+    }
+    counted = ccu.meta.get();
+    bytes += sizeof(CcuRecordMeta) + counted->device_id.capacity() +
+             counted->device_name.capacity() +
+             counted->device_type.capacity() +
+             counted->last_check_time.capacity();
+  }
+  return bytes;
+}
+
+void CcuDetailCache::evictLocked() {
+  while (bytes_ > capacity_bytes_ && !lru_.empty()) {
+    const auto &victim = lru_.back();
+    bytes_ -= victim.bytes;
+    index_.erase(victim.record_id);
+    lru_.pop_back();
+    ++evictions_;
+  }
+}
+
+} // namespace device
@@ -0,0 +1,29 @@
+#include "device/ccu_fault.h"
+
+#include <bit>
+
+namespace device {
+
+FaultSummary SummarizeFaults(const std::vector<CCUAttributes> &ccus) {
+  FaultSummary summary;
+  summary.ccu_count = static_cast<int>(ccus.size());
+
+  for (const auto &ccu : ccus) {
+    const std::uint32_t faults = ccu.flags & ccu_flag::kAllFaults;
+    if (faults == 0) {
+      continue;
+    }
+    ++summary.fault_ccu_count;
+    summary.fault_mask |= faults;
+    summary.ac_contactor_faults +=
+        std::popcount(faults & ccu_flag::kAcContactorFaults);
+    summary.parallel_contactor_faults +=
+        std::popcount(faults & ccu_flag::kParallelContactorFaults);
+    summary.fan_faults += std::popcount(faults & ccu_flag::kFanFaults);
+    summary.gun_faults += std::popcount(faults & ccu_flag::kGunFaults);
+  }
+
+  return summary;
+}
+
+} // namespace device
@@ -0,0 +1,147 @@
+#include "device/detail_prefetcher.h"
+#include "db/db_executor.h"
+#include "db/query_metrics.h"
+#include "device/device_repo.h"
+
+#include <QFutureWatcher>
+#include <absl/status/statusor.h>
+#include <algorithm>
+#include <glog/logging.h>
+
+namespace device {
+
+namespace {
+// 从队列中移除 key（若存在）
+void Erase(std::deque<std::string> &queue, const std::string &key) {
+  auto it = std::find(queue.begin(), queue.end(), key);
+  if (it != queue.end()) {
+    queue.erase(it);
+  }
+}
+} // namespace
+
+DetailPrefetcher::DetailPrefetcher(QObject *parent) : QObject(parent) {}
+
+void DetailPrefetcher::hint(const QString &equipNo, Reason reason) {
+  if (equipNo.isEmpty()) {
+    return;
+  }
+  auto key = equipNo.toStdString();
+
+  switch (reason) {
+  case Hovered:
+    // 重复悬停只提到队首
+    Erase(hovered_, key);
+    hovered_.push_front(std::move(key));
+    if (hovered_.size() > kMaxHovered) {
+      hovered_.pop_back();
+    }
+    break;
+  case Recent:
+    Erase(recent_queue_, key);
+    recent_queue_.push_back(std::move(key));
+    if (recent_queue_.size() > kMaxRecent) {
+      recent_queue_.pop_front();
+    }
+    break;
+  case Visible:
+    if (visible_.size() < kMaxVisible &&
+        std::find(visible_.begin(), visible_.end(), key) == visible_.end()) {
+      visible_.push_back(std::move(key));
+    }
+    break;
+  }
+  pump();
+}
+
+void DetailPrefetcher::setVisible(const QStringList &equipNos) {
+  visible_.clear();
+  for (const auto &equip_no : equipNos) {
+    if (visible_.size() >= kMaxVisible) {
+      break;
+    }
+    if (!equip_no.isEmpty()) {
+      visible_.push_back(equip_no.toStdString());
+    }
+  }
+  pump();
+}
+
+void DetailPrefetcher::markViewed(const QString &equipNo) {
+  if (equipNo.isEmpty()) {
+    return;
+  }
+  const auto key = equipNo.toStdString();
+  Erase(recent_, key);
+  recent_.push_front(key);
+  if (recent_.size() > kMaxRecent) {
+    recent_.pop_back();
+  }
+}
+
+void DetailPrefetcher::onRecordSaved(const QString &equipNo) {
+  const auto key = equipNo.toStdString();
+  no_record_.erase(key);
+  // 只为最近查看过的设备重新预热，其余设备等到可见/悬停时再取
+  if (std::find(recent_.begin(), recent_.end(), key) != recent_.end()) {
+    hint(equipNo, Recent);
+  }
+}
+
+bool DetailPrefetcher::takeNext(std::string *equip_no) {
+  for (auto *queue : {&hovered_, &recent_queue_, &visible_}) {
+    while (!queue->empty()) {
+      auto key = std::move(queue->front());
+      queue->pop_front();
+      if (in_flight_.contains(key) || no_record_.contains(key) ||
+          DeviceRepo::IsLatestCached(key)) {
+        continue;
+      }
+      *equip_no = std::move(key);
+      return true;
+    }
+  }
+  return false;
+}
+
+void DetailPrefetcher::pump() {
+  std::string equip_no;
+  while (static_cast<int>(in_flight_.size()) < kMaxInFlight &&
+         takeNext(&equip_no)) {
+    dispatch(equip_no);
+  }
+}
+
+void DetailPrefetcher::dispatch(const std::string &equip_no) {
+  in_flight_.insert(equip_no);
+
+  auto *watcher = new QFutureWatcher<absl::StatusOr<bool>>(this);
+  connect(watcher, &QFutureWatcher<absl::StatusOr<bool>>::finished, this,
+          [this, watcher, equip_no]() {
+            watcher->deleteLater();
+            auto result = watcher->future().result();
+            if (!result.ok()) {
+              // 预取失败不重试，打开详情页时仍会正常加载
+              VLOG(1) << "[DetailPrefetcher] " << equip_no << ": "
+                      << result.status().message();
+            } else if (!*result) {
+              // 没有记录的设备不会进入缓存，记下来避免每次滚动都重复查询
+              no_record_.insert(equip_no);
+            }
+            in_flight_.erase(equip_no);
+            pump();
+          });
+
+  // 详情只写入 CcuDetailCache，回传到 UI 线程的只有“是否有记录”
+  watcher->setFuture(db::DbExecutor::Submit(
+      db::QueryPriority::kBackground, [equip_no]() -> absl::StatusOr<bool> {
+        db::ScopedQueryOrigin origin("DetailPrefetch");
+        auto details = DeviceRepo::GetLatestPileDetails(equip_no);
+        if (!details.ok()) {
+          return details.status();
+        }
+        return !(*details)->empty();
+      }));
+}
+
+} // namespace device
@@ -0,0 +1,74 @@
+#include "device/device_registry.h"
+
+#include <mutex>
+
+namespace device {
+
+DeviceRegistry &DeviceRegistry::Instance() {
+  static DeviceRegistry registry;
+  return registry;
+}
+
+std::shared_ptr<const DeviceKeys>
+DeviceRegistry::MakeKeys(DeviceHandle handle, const PileAttr &attrs) {
+  auto keys = std::make_shared<DeviceKeys>();
+  keys->handle = handle;
+  keys->equip_no = attrs.equip_no;
+  keys->online_key = "objects:STA#" + attrs.station_no + ":PILE#" +
+                     std::to_string(attrs.equip_order);
+  keys->selfcheck_pattern =
+      "selfcheck:" + attrs.type + "#" + attrs.equip_no + ":CCU#*";
+  return keys;
+}
+
+DeviceHandle DeviceRegistry::intern(const PileAttr &attrs) {
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = by_equip_no_.find(attrs.equip_no);
+    if (it != by_equip_no_.end()) {
+      const auto handle = it->second;
+      auto fresh = MakeKeys(handle, attrs);
+      const auto &cached = *keys_[handle];
+      if (cached.online_key == fresh->online_key &&
+          cached.selfcheck_pattern == fresh->selfcheck_pattern) {
+        return handle;
+      }
+      // 站点/序号/类型变化，升级为写锁后刷新
+      lock.unlock();
+      std::unique_lock<std::shared_mutex> write_lock(mutex_);
+      keys_[handle] = std::move(fresh);
+      return handle;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  auto [it, inserted] = by_equip_no_.try_emplace(
+      attrs.equip_no, static_cast<DeviceHandle>(keys_.size()));
+  if (inserted) {
+    keys_.push_back(MakeKeys(it->second, attrs));
+  }
+  return it->second;
+}
+
+DeviceHandle DeviceRegistry::find(std::string_view equip_no) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto it =
+      by_equip_no_.find(absl::string_view(equip_no.data(), equip_no.size()));
+  return it == by_equip_no_.end() ? kInvalidDeviceHandle : it->second;
+}
+
+std::shared_ptr<const DeviceKeys>
+DeviceRegistry::keys(DeviceHandle handle) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  if (handle >= keys_.size()) {
+    return nullptr;
+  }
+  return keys_[handle];
+}
+
+std::size_t DeviceRegistry::size() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return keys_.size();
+}
+
+} // namespace device
@@ -1,11 +1,83 @@
 #include "device/device_repo.h"
 #include "client/mysql_client.h"
 #include "db/db_row.h"
+#include "db/db_table.h"
+#include "device/ccu_codec.h"
+#include "device/ccu_detail_cache.h"
 #include <absl/strings/str_format.h>
+#include <absl/strings/str_join.h>
+#include <QDateTime>
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
 
 namespace device {
 
+namespace {
+
+constexpr const char *kPileDeviceColumns =
+    "ID, StationNo, EquipNo, EquipName, EquipNameEn, Type, "
+    "IPAddr, GunCount, EquipOrder, Encrypt, SecretKey, SecretIV, "
+    "Data1, Data2, Data3, Data4";
+
+// 单行内容的 CRC32，覆盖 PileDeviceFromDbRow 读取的全部列；
+// NULL 统一转为空串，CHAR(31) 分隔避免相邻列拼接产生歧义
+constexpr const char *kPileRowChecksum =
+    "CRC32(CONCAT_WS(CHAR(31), ID, IFNULL(StationNo, ''), EquipNo, "
+    "IFNULL(EquipName, ''), IFNULL(EquipNameEn, ''), IFNULL(IPAddr, ''), "
+    "IFNULL(GunCount, ''), IFNULL(EquipOrder, ''), IFNULL(Encrypt, ''), "
+    "IFNULL(SecretKey, ''), IFNULL(SecretIV, ''), IFNULL(Data1, ''), "
+    "IFNULL(Data2, ''), IFNULL(Data3, ''), IFNULL(Data4, '')))";
+
+// 历史查询的近期窗口：锚点之前一个月
+constexpr int kRecentWindowMonths = 1;
+
+// 窗口起点 "yyyy-MM-dd HH:mm:ss"。锚点依次取游标、to、当前 UTC 时间；
+// 时钟或时区偏差只影响裁剪效果，窗口内外两次查询使用同一个界值，结果不变
+std::string RecentWindowStart(const HistoryFilter &filter) {
+  constexpr const char *kFormat = "yyyy-MM-dd HH:mm:ss";
+  QDateTime anchor;
+  if (filter.before.has_value()) {
+    anchor = QDateTime::fromString(
+        QString::fromStdString(filter.before->created_at), kFormat);
+  } else if (filter.to.has_value()) {
+    anchor = QDateTime::fromString(QString::fromStdString(*filter.to), kFormat);
+  }
+  if (!anchor.isValid()) {
+    // 多留一天余量，客户端时钟略慢时当天的记录仍落在窗口内
+    anchor = QDateTime::currentDateTimeUtc().addDays(1);
+  }
+  return anchor.addMonths(-kRecentWindowMonths).toString(kFormat).toStdString();
+}
+
+qml_model::HistoryItem HistoryItemFromRow(const db::DbRow &row) {
+  qml_model::HistoryItem item;
+  item.recordId = QString::fromStdString(row.getString("ID"));
+  item.deviceId = QString::fromStdString(row.getString("EquipNo"));
+
+  const auto ts_str = QString::fromStdString(row.getString("CreatedAt"));
+  item.timestamp = QDateTime::fromString(ts_str, Qt::ISODate);
+  if (!item.timestamp.isValid()) {
+    // Fallback to common MySQL DATETIME format
+    item.timestamp = QDateTime::fromString(ts_str, "yyyy-MM-dd HH:mm:ss");
+  }
+
+  item.status = QString::fromStdString(row.getString("Status"));
+  item.summary = QString::fromStdString(row.getString("Summary"));
+  // 摘要列由迁移 v2 回填，NULL 按 0 处理
+  item.ccuCount = row.getInt("CcuCount");
+  item.faultCcuCount = row.getInt("FaultCcuCount");
+  item.acContactorFaults = row.getInt("AcContactorFaults");
+  item.parallelContactorFaults = row.getInt("ParallelContactorFaults");
+  item.fanFaults = row.getInt("FanFaults");
+  item.gunFaults = row.getInt("GunFaults");
+  item.faultMask = static_cast<quint32>(row.getInt64("FaultMask"));
+  return item;
+}
+
+} // namespace
+
 PileAttr DeviceRepo::PileDeviceFromDbRow(const db::DbRow &row) {
   PileAttr attrs;
   attrs.db_id = row.getInt("ID");
@@ -34,11 +106,8 @@ absl::StatusOr<std::vector<PileAttr>> DeviceRepo::GetAllPipeDevices() {
   }
 
   auto rows_result = client->executeQuery(
-      "SELECT ID, StationNo, EquipNo, EquipName, EquipNameEn, Type, "
-      "IPAddr, GunCount, EquipOrder, Encrypt, SecretKey, SecretIV, "
-      "Data1, Data2, Data3, Data4 "
-      "FROM equipment_info "
-      "WHERE Type = 'PILE'");
+      absl::StrFormat("SELECT %s FROM equipment_info WHERE Type = 'PILE'",
+                      kPileDeviceColumns));
 
   if (!rows_result.ok()) {
     return rows_result.status();
@@ -53,58 +122,246 @@ absl::StatusOr<std::vector<PileAttr>> DeviceRepo::GetAllPipeDevices() {
   return attrs;
 }
 
-absl::StatusOr<std::vector<qml_model::HistoryItem>>
-DeviceRepo::GetHistoryItems(const QString &deviceId, int limit) {
+absl::StatusOr<std::vector<PileAttr>>
+DeviceRepo::GetPipeDevicesByEquipNos(const std::vector<std::string> &equipNos) {
+  if (equipNos.empty()) {
+    return std::vector<PileAttr>{};
+  }
   auto *client = db::MySqlClient::GetInstance();
   if (client == nullptr) {
     return absl::InternalError("MySQL client not initialized");
   }
 
-  // 表结构参考 doc/db.md: self_check_record
+  std::string placeholders;
+  std::vector<db::DbValue> params;
+  params.reserve(equipNos.size());
+  for (const auto &equip_no : equipNos) {
+    placeholders += placeholders.empty() ? "?" : ", ?";
+    params.emplace_back(equip_no);
+  }
+
   auto rows_result = client->executeQuery(
-      "SELECT ID, EquipNo, CreatedAt, Status, Summary "
-      "FROM self_check_record "
-      "WHERE EquipNo = ? "
-      "ORDER BY CreatedAt DESC LIMIT ?",
-      {deviceId.toStdString(), static_cast<int64_t>(limit)});
+      absl::StrFormat("SELECT %s FROM equipment_info "
+                      "WHERE Type = 'PILE' AND EquipNo IN (%s)",
+                      kPileDeviceColumns, placeholders),
+      params);
+  if (!rows_result.ok()) {
+    return rows_result.status();
+  }
+
+  std::vector<PileAttr> attrs;
+  attrs.reserve(rows_result->size());
+  for (const auto &row : rows_result.value()) {
+    attrs.push_back(DeviceRepo::PileDeviceFromDbRow(row));
+  }
+  return attrs;
+}
+
+absl::StatusOr<DeviceTableChecksum> DeviceRepo::GetPipeDeviceTableChecksum() {
+  auto *client = db::MySqlClient::GetInstance();
+  if (client == nullptr) {
+    return absl::InternalError("MySQL client not initialized");
+  }
 
+  auto rows_result = client->executeQuery(absl::StrFormat(
+      "SELECT COUNT(*) AS Cnt, BIT_XOR(%s) AS Crc "
+      "FROM equipment_info WHERE Type = 'PILE'",
+      kPileRowChecksum));
   if (!rows_result.ok()) {
     return rows_result.status();
   }
+  if (rows_result->empty()) {
+    return DeviceTableChecksum{};
+  }
 
-  std::vector<qml_model::HistoryItem> items;
-  const auto &rows = rows_result.value();
-  items.reserve(rows.size());
+  const auto &row = rows_result->front();
+  DeviceTableChecksum checksum;
+  checksum.row_count = row.getInt64("Cnt");
+  checksum.crc = static_cast<uint64_t>(row.getInt64("Crc"));
+  return checksum;
+}
 
-  for (const auto &row : rows) {
-    qml_model::HistoryItem item;
-    item.recordId = QString::fromStdString(row.getString("ID"));
-    item.deviceId = QString::fromStdString(row.getString("EquipNo"));
-
-    const auto ts_str = QString::fromStdString(row.getString("CreatedAt"));
-    item.timestamp = QDateTime::fromString(ts_str, Qt::ISODate);
-    if (!item.timestamp.isValid()) {
-      // Fallback to common MySQL DATETIME format
-      item.timestamp = QDateTime::fromString(ts_str, "yyyy-MM-dd HH:mm:ss");
+absl::StatusOr<std::vector<DeviceRowChecksum>>
+DeviceRepo::GetPipeDeviceChecksums() {
+  auto *client = db::MySqlClient::GetInstance();
+  if (client == nullptr) {
+    return absl::InternalError("MySQL client not initialized");
+  }
+
+  auto rows_result = client->executeQuery(absl::StrFormat(
+      "SELECT EquipNo, %s AS Crc FROM equipment_info WHERE Type = 'PILE'",
+      kPileRowChecksum));
+  if (!rows_result.ok()) {
+    return rows_result.status();
+  }
+
+  std::vector<DeviceRowChecksum> checksums;
+  checksums.reserve(rows_result->size());
+  for (const auto &row : rows_result.value()) {
+    DeviceRowChecksum checksum;
+    checksum.equip_no = row.getString("EquipNo");
+    checksum.crc = static_cast<uint32_t>(row.getInt64("Crc"));
+    checksums.push_back(std::move(checksum));
+  }
+  return checksums;
+}
+
+absl::StatusOr<std::vector<qml_model::HistoryItem>>
+DeviceRepo::GetHistoryItems(const QString &deviceId, int limit,
+                            const std::optional<HistoryCursor> &before) {
+  HistoryFilter filter;
+  filter.equip_nos.push_back(deviceId.toStdString());
+  filter.limit = limit;
+  filter.before = before;
+  return SearchHistory(filter);
+}
+
+absl::StatusOr<std::vector<qml_model::HistoryItem>>
+DeviceRepo::SearchHistory(const HistoryFilter &filter) {
+  auto *client = db::MySqlClient::GetInstance();
+  if (client == nullptr) {
+    return absl::InternalError("MySQL client not initialized");
+  }
+
+  std::vector<std::string> conditions;
+  std::vector<db::DbValue> params;
+
+  auto add_in = [&](const char *column,
+                    const std::vector<std::string> &values) {
+    if (values.empty()) {
+      return;
+    }
+    std::string placeholders;
+    for (const auto &value : values) {
+      placeholders += placeholders.empty() ? "?" : ", ?";
+      params.emplace_back(value);
     }
+    conditions.push_back(absl::StrFormat("%s IN (%s)", column, placeholders));
+  };
+
+  add_in("EquipNo", filter.equip_nos);
+  add_in("Status", filter.statuses);
+  add_in("CheckCategory", filter.check_categories);
+  add_in("TriggerSource", filter.trigger_sources);
 
-    item.status = QString::fromStdString(row.getString("Status"));
-    item.summary = QString::fromStdString(row.getString("Summary"));
-    items.push_back(std::move(item));
+  if (filter.from.has_value()) {
+    conditions.emplace_back("CreatedAt >= ?");
+    params.emplace_back(*filter.from);
   }
+  if (filter.to.has_value()) {
+    conditions.emplace_back("CreatedAt < ?");
+    params.emplace_back(*filter.to);
+  }
+  if (filter.before.has_value()) {
+    // 行构造比较无法用于分区裁剪，额外给出 CreatedAt 上界
+    conditions.emplace_back("CreatedAt <= ?");
+    params.emplace_back(filter.before->created_at);
+    conditions.emplace_back("(CreatedAt, ID) < (?, ?)");
+    params.emplace_back(filter.before->created_at);
+    params.emplace_back(filter.before->id);
+  }
+  if (!filter.summary_text.empty()) {
+    std::string pattern = "%";
+    for (char c : filter.summary_text) {
+      if (c == '!' || c == '%' || c == '_') {
+        pattern.push_back('!');
+      }
+      pattern.push_back(c);
+    }
+    pattern.push_back('%');
+    conditions.emplace_back("Summary LIKE ? ESCAPE '!'");
+    params.emplace_back(std::move(pattern));
+  }
+
+  const int limit = std::clamp(filter.limit, 1, kMaxHistoryLimit);
+
+  // 在基础条件上追加一个 CreatedAt 区间条件后查询
+  auto query = [&](const std::optional<std::string> &window_condition,
+                   const std::optional<std::string> &window_bound,
+                   int page_limit)
+      -> absl::StatusOr<std::vector<qml_model::HistoryItem>> {
+    auto page_conditions = conditions;
+    auto page_params = params;
+    if (window_condition.has_value()) {
+      page_conditions.push_back(*window_condition);
+      page_params.emplace_back(*window_bound);
+    }
+
+    // 表结构参考 doc/db.md: self_check_record
+    std::string sql = "SELECT ID, EquipNo, CreatedAt, Status, Summary, "
+                      "CcuCount, FaultCcuCount, AcContactorFaults, "
+                      "ParallelContactorFaults, FanFaults, GunFaults, "
+                      "FaultMask FROM self_check_record ";
+    if (!page_conditions.empty()) {
+      sql += "WHERE " + absl::StrJoin(page_conditions, " AND ") + " ";
+    }
+    sql += "ORDER BY CreatedAt DESC, ID DESC LIMIT ?";
+    page_params.emplace_back(static_cast<int64_t>(page_limit));
+
+    auto rows_result = client->executeQuery(sql, page_params);
+    if (!rows_result.ok()) {
+      return rows_result.status();
+    }
 
+    std::vector<qml_model::HistoryItem> items;
+    items.reserve(rows_result->size());
+    for (const auto &row : rows_result.value()) {
+      items.push_back(HistoryItemFromRow(row));
+    }
+    return items;
+  };
+
+  // 先只查锚点（游标位置 / to / 当前时间）前一个月的窗口，按月分区时只扫描
+  // 1~2 个分区；不够一页再用窗口之前的数据补齐（同一个界值，不重不漏）
+  const auto window_start = RecentWindowStart(filter);
+  if (filter.from.has_value() && *filter.from >= window_start) {
+    return query(std::nullopt, std::nullopt, limit);
+  }
+
+  auto items = query("CreatedAt >= ?", window_start, limit);
+  if (!items.ok() || static_cast<int>(items->size()) >= limit) {
+    return items;
+  }
+  auto older = query("CreatedAt < ?", window_start,
+                     limit - static_cast<int>(items->size()));
+  if (!older.ok()) {
+    return older.status();
+  }
+  items->insert(items->end(), std::make_move_iterator(older->begin()),
+                std::make_move_iterator(older->end()));
   return items;
 }
 
 absl::StatusOr<std::vector<device::CCUAttributes>>
 DeviceRepo::GetPileItems(const QString &recordId) {
+  bool ok = false;
+  const auto record_id = recordId.toLongLong(&ok);
+  if (!ok) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("invalid record id: %s", recordId.toStdString()));
+  }
+
+  auto details = GetPileDetails(record_id);
+  if (!details.ok()) {
+    return details.status();
+  }
+  return **details;
+}
+
+absl::StatusOr<CcuDetailsPtr> DeviceRepo::GetPileDetails(int64_t recordId) {
+  auto &cache = CcuDetailCache::Instance();
+  if (auto cached = cache.get(recordId)) {
+    return cached;
+  }
+
   auto *client = db::MySqlClient::GetInstance();
   if (client == nullptr) {
     return absl::InternalError("MySQL client not initialized");
   }
 
   auto rows_result = client->executeQuery(
-      "SELECT * FROM self_check_record WHERE ID = ?", {recordId.toStdString()});
+      "SELECT CreatedAt, DetailsJSON FROM self_check_record WHERE ID = ?",
+      {recordId});
 
   if (!rows_result.ok()) {
     return rows_result.status();
@@ -113,10 +370,24 @@ DeviceRepo::GetPileItems(const QString &recordId) {
   const auto &rows = rows_result.value();
   if (rows.empty()) {
     return absl::NotFoundError(
-        absl::StrFormat("record not found for id: %s", recordId.toStdString()));
+        absl::StrFormat("record not found for id: %d", recordId));
   }
 
-  const auto detail_json_str = rows.front().getString("DetailsJSON");
+  auto attributes = DecodeDetailsJson(rows.front().getString("DetailsJSON"),
+                                      rows.front().getString("CreatedAt"));
+  if (!attributes.ok()) {
+    return attributes.status();
+  }
+
+  auto details =
+      std::make_shared<const CcuDetails>(std::move(attributes).value());
+  cache.put(recordId, details);
+  return details;
+}
+
+absl::StatusOr<std::vector<device::CCUAttributes>>
+DeviceRepo::DecodeDetailsJson(const std::string &detail_json_str,
+                              const std::string &create_at) {
 
   nlohmann::json detail_json; // NOLINT
   try {
@@ -140,102 +411,24 @@ DeviceRepo::GetPileItems(const QString &recordId) {
     return it->get<std::string>();
   };
 
-  const std::string device_id = get_string(detail_json, "deviceId");
-  const std::string device_name = get_string(detail_json, "deviceName");
-  const std::string device_type = get_string(detail_json, "deviceType");
-  const auto create_at = rows.front().getString("CreatedAt");
+  // 元信息整条记录只保存一份，所有 CCU 共享
+  auto meta = std::make_shared<CcuRecordMeta>();
+  meta->device_id = get_string(detail_json, "deviceId");
+  meta->device_name = get_string(detail_json, "deviceName");
+  meta->device_type = get_string(detail_json, "deviceType");
+  meta->last_check_time = create_at;
 
   const auto &modules = detail_json["ccuModules"];
   std::vector<device::CCUAttributes> attributes;
   attributes.reserve(modules.size());
 
-  auto get_nested_bool = [](const nlohmann::json &obj,
-                            const std::string &key) -> bool {
-    if (!obj.is_object()) {
-      return false;
-    }
-    auto it = obj.find(key);
-    if (it == obj.end() || !it->is_boolean()) {
-      return false;
-    }
-    return it->get<bool>();
-  };
-
   for (const auto &module : modules) {
     if (!module.is_object()) {
       continue;
     }
 
-    device::CCUAttributes attr;
-    attr.index = module.value("index", 0);
-    attr.device_id = device_id;
-    attr.device_name = device_name;
-    attr.device_type = device_type;
-    attr.last_check_time = create_at;
-
-    const auto &ac1 = module.value("acContactor1", nlohmann::json::object());
-    attr.ac_contactor_1.contactor1_stuck = get_nested_bool(ac1, "stuck");
-    attr.ac_contactor_1.contactor1_refuse = get_nested_bool(ac1, "refuse");
-
-    const auto &ac2 = module.value("acContactor2", nlohmann::json::object());
-    attr.ac_contactor_2.contactor1_stuck = get_nested_bool(ac2, "stuck");
-    attr.ac_contactor_2.contactor1_refuse = get_nested_bool(ac2, "refuse");
-
-    const auto &parallel =
-        module.value("parallelContactor", nlohmann::json::object());
-    attr.parallel_contactor.positive_stuck =
-        get_nested_bool(parallel, "positiveStuck");
-    attr.parallel_contactor.positive_refuse =
-        get_nested_bool(parallel, "positiveRefuse");
-    attr.parallel_contactor.negative_stuck =
-        get_nested_bool(parallel, "negativeStuck");
-    attr.parallel_contactor.negative_refuse =
-        get_nested_bool(parallel, "negativeRefuse");
-
-    const auto &fan1 = module.value("fan1", nlohmann::json::object());
-    attr.fan_1.stopped = get_nested_bool(fan1, "stopped");
-    attr.fan_1.rotating = get_nested_bool(fan1, "rotating");
-
-    const auto &fan2 = module.value("fan2", nlohmann::json::object());
-    attr.fan_2.stopped = get_nested_bool(fan2, "stopped");
-    attr.fan_2.rotating = get_nested_bool(fan2, "rotating");
-
-    const auto &fan3 = module.value("fan3", nlohmann::json::object());
-    attr.fan_3.stopped = get_nested_bool(fan3, "stopped");
-    attr.fan_3.rotating = get_nested_bool(fan3, "rotating");
-
-    const auto &fan4 = module.value("fan4", nlohmann::json::object());
-    attr.fan_4.stopped = get_nested_bool(fan4, "stopped");
-    attr.fan_4.rotating = get_nested_bool(fan4, "rotating");
-
-    const auto &gun_a = module.value("gunA", nlohmann::json::object());
-    attr.gun_a.positive_contactor_stuck =
-        get_nested_bool(gun_a, "positiveContactorStuck");
-    attr.gun_a.positive_contactor_refuse =
-        get_nested_bool(gun_a, "positiveContactorRefuse");
-    attr.gun_a.negative_contactor_stuck =
-        get_nested_bool(gun_a, "negativeContactorStuck");
-    attr.gun_a.negative_contactor_refuse =
-        get_nested_bool(gun_a, "negativeContactorRefuse");
-    attr.gun_a.unlocked = get_nested_bool(gun_a, "unlocked");
-    attr.gun_a.locked = get_nested_bool(gun_a, "locked");
-    attr.gun_a.aux_power_12v = get_nested_bool(gun_a, "auxPower12v");
-    attr.gun_a.aux_power_24v = get_nested_bool(gun_a, "auxPower24v");
-
-    const auto &gun_b = module.value("gunB", nlohmann::json::object());
-    attr.gun_b.positive_contactor_stuck =
-        get_nested_bool(gun_b, "positiveContactorStuck");
-    attr.gun_b.positive_contactor_refuse =
-        get_nested_bool(gun_b, "positiveContactorRefuse");
-    attr.gun_b.negative_contactor_stuck =
-        get_nested_bool(gun_b, "negativeContactorStuck");
-    attr.gun_b.negative_contactor_refuse =
-        get_nested_bool(gun_b, "negativeContactorRefuse");
-    attr.gun_b.unlocked = get_nested_bool(gun_b, "unlocked");
-    attr.gun_b.locked = get_nested_bool(gun_b, "locked");
-    attr.gun_b.aux_power_12v = get_nested_bool(gun_b, "auxPower12v");
-    attr.gun_b.aux_power_24v = get_nested_bool(gun_b, "auxPower24v");
-
+    auto attr = DecodeCcuModule(module);
+    attr.meta = meta;
     attributes.emplace_back(std::move(attr));
   }
 
@@ -244,29 +437,290 @@ DeviceRepo::GetPileItems(const QString &recordId) {
 
 absl::StatusOr<std::vector<device::CCUAttributes>>
 DeviceRepo::GetLatestPileItems(const QString &deviceId) {
+  auto details = GetLatestPileDetails(deviceId.toStdString());
+  if (!details.ok()) {
+    return details.status();
+  }
+  return **details;
+}
+
+absl::StatusOr<CcuDetailsPtr>
+DeviceRepo::GetLatestPileDetails(const std::string &equip_no) {
+  auto &cache = CcuDetailCache::Instance();
+
+  std::uint64_t epoch = 0;
+  auto latest_id = cache.latestRecordId(equip_no, &epoch);
+  if (!latest_id.has_value()) {
+    auto *client = db::MySqlClient::GetInstance();
+    if (client == nullptr) {
+      return absl::InternalError("MySQL client not initialized");
+    }
+
+    // 查询该设备最新的检查记录ID
+    // 先限定近一个月，按月分区时只需扫描 1~2 个分区；没有再查全表
+    auto rows_result = client->executeQuery(
+        "SELECT ID FROM self_check_record "
+        "WHERE EquipNo = ? "
+        "AND CreatedAt >= CURRENT_DATE - INTERVAL 1 MONTH "
+        "ORDER BY CreatedAt DESC, ID DESC "
+        "LIMIT 1",
+        {equip_no});
+    if (rows_result.ok() && rows_result->empty()) {
+      rows_result = client->executeQuery("SELECT ID FROM self_check_record "
+                                         "WHERE EquipNo = ? "
+                                         "ORDER BY CreatedAt DESC, ID DESC "
+                                         "LIMIT 1",
+                                         {equip_no});
+    }
+
+    if (!rows_result.ok()) {
+      return rows_result.status();
+    }
+
+    const auto &rows = rows_result.value();
+    if (rows.empty()) {
+      // 设备没有检查记录，返回空列表
+      return std::make_shared<const CcuDetails>();
+    }
+
+    latest_id = rows.front().getInt64("ID");
+    cache.setLatestRecordId(equip_no, *latest_id, epoch);
+  }
+
+  return GetPileDetails(*latest_id);
+}
+
+CcuDetailsPtr DeviceRepo::PeekLatestPileDetails(const std::string &equipNo) {
+  auto &cache = CcuDetailCache::Instance();
+  const auto latest_id = cache.latestRecordId(equipNo);
+  if (!latest_id.has_value()) {
+    return nullptr;
+  }
+  return cache.get(*latest_id);
+}
+
+bool DeviceRepo::IsLatestCached(const std::string &equipNo) {
+  auto &cache = CcuDetailCache::Instance();
+  const auto latest_id = cache.latestRecordId(equipNo);
+  return latest_id.has_value() && cache.contains(*latest_id);
+}
+
+void DeviceRepo::InvalidateLatest(const std::string &equipNo) {
+  CcuDetailCache::Instance().invalidateLatest(equipNo);
+}
+
+absl::StatusOr<std::vector<LatestCheckSummary>>
+DeviceRepo::GetLatestCheckSummaries(
+    const std::unordered_set<std::string> &equipNos) {
   auto *client = db::MySqlClient::GetInstance();
   if (client == nullptr) {
     return absl::InternalError("MySQL client not initialized");
   }
 
-  // 查询该设备最新的检查记录ID
-  auto rows_result = client->executeQuery("SELECT ID FROM self_check_record "
-                                          "WHERE EquipNo = ? "
-                                          "ORDER BY CreatedAt DESC LIMIT 1",
-                                          {deviceId.toStdString()});
+  std::vector<LatestCheckSummary> summaries;
+  // 摘要列尚未回填（迁移 v2 之前写入）的记录，下标 -> ID
+  std::vector<std::pair<std::size_t, std::string>> pending;
+  auto append_rows = [&summaries,
+                      &pending](const std::vector<db::DbRow> &rows) {
+    for (const auto &row : rows) {
+      if (row.getInt("Pending") != 0) {
+        pending.emplace_back(summaries.size(), row.getString("ID"));
+      }
+      LatestCheckSummary summary;
+      summary.equip_no = row.getString("EquipNo");
+      summary.record_id = row.getString("ID");
+      summary.status = row.getString("Status");
+      summary.created_at = row.getString("CreatedAt");
+      summary.ccu_count = row.getInt("CcuCount");
+      summary.fail_count = row.getInt("FailCount");
+      summaries.push_back(std::move(summary));
+    }
+  };
 
+  // ID 自增且 CreatedAt 取插入时间，每台设备 MAX(ID) 即最新记录；
+  // GROUP BY EquipNo + MAX(ID) 可走 idx_equip 的松散索引扫描。
+  // CCU 数与故障 CCU 数直接读摘要列（迁移 v2），摘要列尚未回填的记录另行现算。
+  // 子查询与回表都带 CreatedAt 下界，按月分区时只扫描最近 1~2 个分区
+  const auto window_start = RecentWindowStart(HistoryFilter{});
+  auto rows_result = client->executeQuery(
+      "SELECT r.ID, r.EquipNo, r.Status, r.CreatedAt, "
+      "r.CcuCount IS NULL AS Pending, "
+      "COALESCE(r.CcuCount, 0) AS CcuCount, "
+      "COALESCE(r.FaultCcuCount, 0) AS FailCount "
+      "FROM (SELECT EquipNo, MAX(ID) AS ID FROM self_check_record "
+      "WHERE CreatedAt >= ? GROUP BY EquipNo) latest "
+      "JOIN self_check_record r "
+      "ON r.ID = latest.ID AND r.EquipNo = latest.EquipNo "
+      "AND r.CreatedAt >= ?",
+      {window_start, window_start});
+  if (!rows_result.ok()) {
+    return rows_result.status();
+  }
+  append_rows(rows_result.value());
+
+  // 窗口内没有记录的设备才回退到更早的分区，按批限定设备编号
+  std::unordered_set<std::string> found;
+  found.reserve(summaries.size());
+  for (const auto &summary : summaries) {
+    found.insert(summary.equip_no);
+  }
+  std::vector<std::string> missing;
+  for (const auto &equip_no : equipNos) {
+    if (found.count(equip_no) == 0) {
+      missing.push_back(equip_no);
+    }
+  }
+
+  constexpr std::size_t kFallbackBatch = 500;
+  for (std::size_t begin = 0; begin < missing.size();
+       begin += kFallbackBatch) {
+    const std::size_t end = std::min(missing.size(), begin + kFallbackBatch);
+    std::vector<db::DbValue> params;
+    std::string placeholders;
+    for (std::size_t i = begin; i < end; ++i) {
+      placeholders += placeholders.empty() ? "?" : ", ?";
+      params.emplace_back(missing[i]);
+    }
+    params.emplace_back(window_start);
+    params.emplace_back(window_start);
+
+    auto older = client->executeQuery(
+        absl::StrFormat(
+            "SELECT r.ID, r.EquipNo, r.Status, r.CreatedAt, "
+            "r.CcuCount IS NULL AS Pending, "
+            "COALESCE(r.CcuCount, 0) AS CcuCount, "
+            "COALESCE(r.FaultCcuCount, 0) AS FailCount "
+            "FROM (SELECT EquipNo, MAX(ID) AS ID FROM self_check_record "
+            "WHERE EquipNo IN (%s) AND CreatedAt < ? GROUP BY EquipNo) latest "
+            "JOIN self_check_record r "
+            "ON r.ID = latest.ID AND r.EquipNo = latest.EquipNo "
+            "AND r.CreatedAt < ?",
+            placeholders),
+        params);
+    if (!older.ok()) {
+      return older.status();
+    }
+    append_rows(older.value());
+  }
+
+  // 后台回填完成之前，未回填记录的 CCU 数与故障 CCU 数按 DetailsJSON 现算
+  // （每台设备至多一条最新记录），口径与回填写入的摘要列一致
+  for (std::size_t begin = 0; begin < pending.size();
+       begin += kFallbackBatch) {
+    const std::size_t end = std::min(pending.size(), begin + kFallbackBatch);
+    std::vector<db::DbValue> params;
+    std::string placeholders;
+    std::unordered_map<std::string, std::size_t> index_by_id;
+    for (std::size_t i = begin; i < end; ++i) {
+      placeholders += placeholders.empty() ? "?" : ", ?";
+      params.emplace_back(pending[i].second);
+      index_by_id.emplace(pending[i].second, pending[i].first);
+    }
+
+    auto computed = client->executeQuery(
+        db::FaultSummarySelectSql(
+            absl::StrFormat("s.ID IN (%s)", placeholders)),
+        params);
+    if (!computed.ok()) {
+      return computed.status();
+    }
+    for (const auto &row : computed.value()) {
+      auto it = index_by_id.find(row.getString("ID"));
+      if (it == index_by_id.end()) {
+        continue;
+      }
+      auto &summary = summaries[it->second];
+      summary.ccu_count = row.getInt("CcuCount");
+      summary.fail_count = row.getInt("FaultCcuCount");
+    }
+  }
+  return summaries;
+}
+
+namespace {
+
+// 日汇总各计数列，按日聚合时统一 SUM / BIT_OR
+constexpr const char *kRollupAggregateColumns =
+    "SUM(r.TotalCount) AS TotalCount, SUM(r.OkCount) AS OkCount, "
+    "SUM(r.WarnCount) AS WarnCount, SUM(r.ErrorCount) AS ErrorCount, "
+    "SUM(r.FaultCcuCount) AS FaultCcuCount, "
+    "SUM(r.AcContactorFaults) AS AcContactorFaults, "
+    "SUM(r.ParallelContactorFaults) AS ParallelContactorFaults, "
+    "SUM(r.FanFaults) AS FanFaults, SUM(r.GunFaults) AS GunFaults, "
+    "BIT_OR(r.FaultMask) AS FaultMask ";
+
+absl::StatusOr<std::vector<DailyRollup>>
+QueryDailyRollups(const std::string &sql,
+                  const std::vector<db::DbValue> &params) {
+  auto *client = db::MySqlClient::GetInstance();
+  if (client == nullptr) {
+    return absl::InternalError("MySQL client not initialized");
+  }
+
+  auto rows_result = client->executeQuery(sql, params);
   if (!rows_result.ok()) {
     return rows_result.status();
   }
 
   const auto &rows = rows_result.value();
-  if (rows.empty()) {
-    // 设备没有检查记录，返回空列表
-    return std::vector<device::CCUAttributes>{};
+  std::vector<DailyRollup> rollups;
+  rollups.reserve(rows.size());
+  for (const auto &row : rows) {
+    DailyRollup rollup;
+    rollup.day = row.getString("Day");
+    rollup.total_count = row.getInt("TotalCount");
+    rollup.ok_count = row.getInt("OkCount");
+    rollup.warn_count = row.getInt("WarnCount");
+    rollup.error_count = row.getInt("ErrorCount");
+    rollup.fault_ccu_count = row.getInt("FaultCcuCount");
+    rollup.ac_contactor_faults = row.getInt("AcContactorFaults");
+    rollup.parallel_contactor_faults = row.getInt("ParallelContactorFaults");
+    rollup.fan_faults = row.getInt("FanFaults");
+    rollup.gun_faults = row.getInt("GunFaults");
+    rollup.fault_mask = static_cast<uint32_t>(row.getInt64("FaultMask"));
+    rollups.push_back(std::move(rollup));
   }
+  return rollups;
+}
+
+} // namespace
+
+absl::StatusOr<std::vector<DailyRollup>>
+DeviceRepo::GetDeviceDailyRollups(const std::string &equipNo,
+                                  const std::string &fromDay,
+                                  const std::string &toDay) {
+  // 走 idx_equip_day
+  return QueryDailyRollups(
+      std::string("SELECT r.Day, ") + kRollupAggregateColumns +
+          "FROM self_check_daily_rollup r "
+          "WHERE r.EquipNo = ? AND r.Day BETWEEN ? AND ? "
+          "GROUP BY r.Day ORDER BY r.Day",
+      {equipNo, fromDay, toDay});
+}
+
+absl::StatusOr<std::vector<DailyRollup>>
+DeviceRepo::GetStationDailyRollups(const std::string &stationNo,
+                                   const std::string &fromDay,
+                                   const std::string &toDay) {
+  return QueryDailyRollups(
+      std::string("SELECT r.Day, ") + kRollupAggregateColumns +
+          "FROM self_check_daily_rollup r "
+          "JOIN equipment_info e ON e.EquipNo = r.EquipNo "
+          "WHERE e.StationNo = ? AND r.Day BETWEEN ? AND ? "
+          "GROUP BY r.Day ORDER BY r.Day",
+      {stationNo, fromDay, toDay});
+}
 
-  const auto recordId = QString::fromStdString(rows.front().getString("ID"));
-  return GetPileItems(recordId);
+absl::StatusOr<std::vector<DailyRollup>>
+DeviceRepo::GetFleetDailyRollups(const std::string &fromDay,
+                                 const std::string &toDay) {
+  // 主键 (Day, EquipNo) 前缀范围扫描
+  return QueryDailyRollups(
+      std::string("SELECT r.Day, ") + kRollupAggregateColumns +
+          "FROM self_check_daily_rollup r "
+          "WHERE r.Day BETWEEN ? AND ? "
+          "GROUP BY r.Day ORDER BY r.Day",
+      {fromDay, toDay});
 }
 
 } // namespace device
@@ -0,0 +1,278 @@
+#include "device/device_snapshot.h"
+
+#include "device/pile_device.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <absl/strings/str_format.h>
+#include <glog/logging.h>
+
+#include <chrono>
+#include <cstring>
+#include <type_traits>
+
+namespace device {
+
+namespace {
+
+constexpr char kMagic[8] = {'E', 'A', 'C', 'S', 'N', 'A', 'P', '\0'};
+
+struct StrRef {
+  std::uint32_t offset;
+  std::uint32_t size;
+};
+
+struct Header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t record_size; // sizeof(Record)，结构变化时必须升级 version
+  std::uint32_t entry_count;
+  std::uint32_t strings_size;
+  std::int64_t saved_at; // unix 秒
+  std::uint64_t checksum; // Record 区 + 字符串区的 FNV-1a
+};
+
+struct Record {
+  std::int32_t db_id;
+  std::int32_t gun_count;
+  std::int32_t equip_order;
+  std::int32_t encrypt;
+  std::int32_t data1;
+  std::int32_t data3;
+  StrRef station_no;
+  StrRef equip_no;
+  StrRef name;
+  StrRef name_en;
+  StrRef type;
+  StrRef ip_addr;
+  StrRef data2_json;
+  StrRef data4_json;
+  StrRef last_check_time;
+  std::int32_t check_status;
+  std::int32_t last_check_result;
+  std::int32_t success_count;
+  std::int32_t fail_count;
+  std::int32_t online_state;
+};
+
+static_assert(std::is_trivially_copyable_v<Header>);
+static_assert(std::is_trivially_copyable_v<Record>);
+static_assert(sizeof(Header) % alignof(Record) == 0);
+
+std::uint64_t Fnv1a(const char *data, std::size_t size,
+                    std::uint64_t hash = 1469598103934665603ULL) {
+  for (std::size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+class StringBlob {
+public:
+  StrRef add(const std::string &value) {
+    StrRef ref{static_cast<std::uint32_t>(blob_.size()),
+               static_cast<std::uint32_t>(value.size())};
+    blob_.append(value);
+    return ref;
+  }
+  const std::string &data() const { return blob_; }
+
+private:
+  std::string blob_;
+};
+
+} // namespace
+
+QString DeviceSnapshot::DefaultPath() {
+  return QDir::homePath() + QStringLiteral("/ECheckAuto/cache/device_snapshot.bin");
+}
+
+absl::StatusOr<std::vector<DeviceSnapshotEntry>>
+DeviceSnapshot::Load(const QString &path) {
+  QFile file(path);
+  if (!file.exists()) {
+    return absl::NotFoundError("snapshot not found: " + path.toStdString());
+  }
+  if (!file.open(QIODevice::ReadOnly)) {
+    return absl::UnavailableError("open snapshot failed: " +
+                                  file.errorString().toStdString());
+  }
+
+  const qint64 file_size = file.size();
+  if (file_size < static_cast<qint64>(sizeof(Header))) {
+    return absl::DataLossError("snapshot truncated");
+  }
+  uchar *mapped = file.map(0, file_size);
+  if (mapped == nullptr) {
+    return absl::UnavailableError("mmap snapshot failed: " +
+                                  file.errorString().toStdString());
+  }
+  const char *base = reinterpret_cast<const char *>(mapped);
+
+  Header header;
+  std::memcpy(&header, base, sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    return absl::DataLossError("bad snapshot magic");
+  }
+  if (header.version != kVersion || header.record_size != sizeof(Record)) {
+    return absl::DataLossError(
+        absl::StrFormat("unsupported snapshot version %d (record size %d)",
+                        header.version, header.record_size));
+  }
+
+  const std::uint64_t records_size =
+      static_cast<std::uint64_t>(header.entry_count) * sizeof(Record);
+  if (sizeof(Header) + records_size + header.strings_size !=
+      static_cast<std::uint64_t>(file_size)) {
+    return absl::DataLossError("snapshot size mismatch");
+  }
+
+  const char *records_base = base + sizeof(Header);
+  const char *strings = records_base + records_size;
+  if (Fnv1a(records_base, records_size + header.strings_size) !=
+      header.checksum) {
+    return absl::DataLossError("snapshot checksum mismatch");
+  }
+
+  bool bad_ref = false;
+  auto str = [&](const StrRef &ref) -> std::string {
+    if (static_cast<std::uint64_t>(ref.offset) + ref.size >
+        header.strings_size) {
+      bad_ref = true;
+      return {};
+    }
+    return std::string(strings + ref.offset, ref.size);
+  };
+
+  std::vector<DeviceSnapshotEntry> entries;
+  entries.reserve(header.entry_count);
+  for (std::uint32_t i = 0; i < header.entry_count; ++i) {
+    // 映射地址按页对齐、Header 长度是 Record 对齐的整数倍，可直接按 Record 访问
+    const auto &rec = reinterpret_cast<const Record *>(records_base)[i];
+
+    DeviceSnapshotEntry entry;
+    entry.attrs.db_id = rec.db_id;
+    entry.attrs.gun_count = rec.gun_count;
+    entry.attrs.equip_order = rec.equip_order;
+    entry.attrs.encrypt = rec.encrypt;
+    entry.attrs.data1 = rec.data1;
+    entry.attrs.data3 = rec.data3;
+    entry.attrs.station_no = str(rec.station_no);
+    entry.attrs.equip_no = str(rec.equip_no);
+    entry.attrs.name = str(rec.name);
+    entry.attrs.name_en = str(rec.name_en);
+    entry.attrs.type = str(rec.type);
+    entry.attrs.ip_addr = str(rec.ip_addr);
+    entry.attrs.data2_json = str(rec.data2_json);
+    entry.attrs.data4_json = str(rec.data4_json);
+    entry.last_check.last_check_time_str = str(rec.last_check_time);
+    entry.last_check.status = static_cast<SelfCheckStatus>(rec.check_status);
+    entry.last_check.last_check_result = rec.last_check_result;
+    entry.last_check.success_count = rec.success_count;
+    entry.last_check.fail_count = rec.fail_count;
+    entry.online_state = static_cast<OnlineState>(rec.online_state);
+    if (bad_ref) {
+      return absl::DataLossError("snapshot string reference out of range");
+    }
+    entries.push_back(std::move(entry));
+  }
+
+  file.unmap(mapped);
+  return entries;
+}
+
+absl::Status
+DeviceSnapshot::Save(const QString &path,
+                     const std::vector<DeviceSnapshotEntry> &entries) {
+  StringBlob blob;
+  std::vector<Record> records;
+  records.reserve(entries.size());
+  for (const auto &entry : entries) {
+    const auto &attrs = entry.attrs;
+    Record rec{};
+    rec.db_id = attrs.db_id;
+    rec.gun_count = attrs.gun_count;
+    rec.equip_order = attrs.equip_order;
+    rec.encrypt = attrs.encrypt;
+    rec.data1 = attrs.data1;
+    rec.data3 = attrs.data3;
+    rec.station_no = blob.add(attrs.station_no);
+    rec.equip_no = blob.add(attrs.equip_no);
+    rec.name = blob.add(attrs.name);
+    rec.name_en = blob.add(attrs.name_en);
+    rec.type = blob.add(attrs.type);
+    rec.ip_addr = blob.add(attrs.ip_addr);
+    rec.data2_json = blob.add(attrs.data2_json);
+    rec.data4_json = blob.add(attrs.data4_json);
+    rec.last_check_time = blob.add(entry.last_check.last_check_time_str);
+    rec.check_status = static_cast<std::int32_t>(entry.last_check.status);
+    rec.last_check_result = entry.last_check.last_check_result;
+    rec.success_count = entry.last_check.success_count;
+    rec.fail_count = entry.last_check.fail_count;
+    rec.online_state = static_cast<std::int32_t>(entry.online_state);
+    records.push_back(rec);
+  }
+
+  const auto *records_data = reinterpret_cast<const char *>(records.data());
+  const std::size_t records_size = records.size() * sizeof(Record);
+  const auto &strings = blob.data();
+
+  Header header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.record_size = sizeof(Record);
+  header.entry_count = static_cast<std::uint32_t>(records.size());
+  header.strings_size = static_cast<std::uint32_t>(strings.size());
+  header.saved_at = std::chrono::duration_cast<std::chrono::seconds>(
+                        std::chrono::system_clock::now().time_since_epoch())
+                        .count();
+  header.checksum = Fnv1a(strings.data(), strings.size(),
+                          Fnv1a(records_data, records_size));
+
+  if (!QDir().mkpath(QFileInfo(path).absolutePath())) {
+    return absl::UnavailableError("create snapshot dir failed: " +
+                                  path.toStdString());
+  }
+
+  QSaveFile file(path);
+  if (!file.open(QIODevice::WriteOnly)) {
+    return absl::UnavailableError("open snapshot for write failed: " +
+                                  file.errorString().toStdString());
+  }
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(records_data, static_cast<qint64>(records_size));
+  file.write(strings.data(), static_cast<qint64>(strings.size()));
+  if (!file.commit()) {
+    return absl::UnavailableError("write snapshot failed: " +
+                                  file.errorString().toStdString());
+  }
+  return absl::OkStatus();
+}
+
+std::vector<DeviceSnapshotEntry> DeviceSnapshot::Capture(
+    const std::vector<std::shared_ptr<const PileDevice>> &devices) {
+  std::vector<DeviceSnapshotEntry> entries;
+  entries.reserve(devices.size());
+  for (const auto &device : devices) {
+    DeviceSnapshotEntry entry;
+    entry.attrs = device->Attributes();
+    entry.attrs.secret_key.clear();
+    entry.attrs.secret_iv.clear();
+    entry.attrs.ccu_attributes.clear();
+    const auto &check = device->LastSelfCheck();
+    entry.last_check.status = check.status;
+    entry.last_check.last_check_result = check.last_check_result;
+    entry.last_check.success_count = check.success_count;
+    entry.last_check.fail_count = check.fail_count;
+    entry.last_check.last_check_time_str = device->LastCheckTime();
+    entry.online_state = device->Status().online_state;
+    entries.push_back(std::move(entry));
+  }
+  return entries;
+}
+
+} // namespace device
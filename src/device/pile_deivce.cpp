@@ -1,7 +1,8 @@
 #include "device/pile_device.h"
 
 namespace device {
-PileDevice::PileDevice(const PileAttr &attrs) {
+PileDevice::PileDevice(const PileAttr &attrs, DeviceHandle handle)
+    : handle_(handle) {
   attrs_ = attrs;
   status_ = DeviceStatus();
   last_self_check_ = SelfCheckResult();
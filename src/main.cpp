@@ -1,27 +1,42 @@
+#include <QFutureWatcher>
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 #include <QQmlEngine>
 #include <QQuickStyle>
+#include <QTimer>
 
 #include "check_manager.h"
 #include "client/mysql_client.h"
 #include "client/rabbitmq_client.h"
 #include "client/redis_client.h"
+#include "db/db_executor.h"
+#include "db/query_metrics.h"
 #include "db/db_table.h"
+#include "db/partition_maintainer.h"
+#include "device/ccu_detail_cache.h"
+#include "device/detail_prefetcher.h"
 #include "device/device_repo.h"
+#include "device/device_snapshot.h"
+#include "model/device_filter_model.h"
 #include "model/device_model.h"
 #include "model/history_model.h"
 #include "model/pile_model.h"
+#include "model/station_model.h"
 #include "utils/log_init.h"
+#include "watcher/device_sync_watcher.h"
 #include "watcher/online_status_watcher.h"
 
 #include <absl/status/status.h>
+#include <absl/status/statusor.h>
 #include <glog/logging.h>
 #include <yaml-cpp/yaml.h>
 
 #include <chrono>
 #include <iomanip>
+#include <memory>
 #include <sstream>
+#include <unordered_set>
+#include <utility>
 
 absl::Status InitClient() {
   auto mysqlConfig = db::Config::FromYamlFile("config/base.yaml");
@@ -32,80 +47,157 @@ absl::Status InitClient() {
     return status;
   }
 
+  if (auto status = db::RunSchemaMigrations(); !status.ok()) {
+    LOG(ERROR) << "数据库迁移失败: " << status.message();
+    return status;
+  }
+
+  YAML::Node root = YAML::LoadFile("config/base.yaml");
+  db::PartitionMaintainer::Init(
+      db::MaintenanceConfig::FromYaml(root["maintenance"]));
+
   auto rabbitConfig = client::RabbitMqConfig::FromYamlFile("config/base.yaml");
   client::RabbitMqClient::Init(rabbitConfig);
 
-  YAML::Node root = YAML::LoadFile("config/base.yaml");
   client::RedisClient::Init(root["redis"]);
   client::RedisClient::GetInstance()->Connect();
 
   return absl::OkStatus();
 }
 
-// 加载设备的最后检测信息
+// 加载设备的最后检测信息（单次批量查询）
 void LoadLatestCheckInfo(qml_model::DeviceModel *device_model,
-                         const std::vector<device::PileAttr> &devices) {
-  for (const auto &device_attr : devices) {
-    const auto &equip_no = device_attr.equip_no;
-    auto result =
-        device::DeviceRepo::GetLatestPileItems(QString::fromStdString(equip_no));
-
-    if (!result.ok()) {
-      DLOG(WARNING) << "获取设备最后检测信息失败: " << equip_no << ", "
-                    << result.status().message();
-      continue;
-    }
+                         const std::unordered_set<std::string> &known) {
+  auto result = device::DeviceRepo::GetLatestCheckSummaries(known);
+  if (!result.ok()) {
+    LOG(WARNING) << "获取设备最后检测信息失败: " << result.status().message();
+    return;
+  }
 
-    const auto &ccu_items = result.value();
-    if (ccu_items.empty()) {
-      DLOG(INFO) << "设备无历史检测记录: " << equip_no;
+  std::vector<std::pair<std::string, device::SelfCheckResult>> updates;
+  updates.reserve(result->size());
+  for (const auto &summary : result.value()) {
+    // 结果只含有记录的设备；CCU 数为 0 的记录同样发布最后检测时间
+    if (known.count(summary.equip_no) == 0) {
       continue;
     }
 
     // 构建 SelfCheckResult，主要用于更新最后检测时间
     device::SelfCheckResult check_result;
-    check_result.last_check_time_str = ccu_items.front().last_check_time;
-    check_result.status = device::SelfCheckStatus::Passed; // 有记录说明已完成
-
-    // 统计成功/失败数量（简单判断：任何异常状态都算失败）
-    int fail_count = 0;
-    for (const auto &ccu : ccu_items) {
-      // 检查各模块是否有异常
-      if (ccu.ac_contactor_1.contactor1_stuck ||
-          ccu.ac_contactor_1.contactor1_refuse ||
-          ccu.ac_contactor_2.contactor1_stuck ||
-          ccu.ac_contactor_2.contactor1_refuse ||
-          ccu.parallel_contactor.positive_stuck ||
-          ccu.parallel_contactor.positive_refuse ||
-          ccu.parallel_contactor.negative_stuck ||
-          ccu.parallel_contactor.negative_refuse) {
-        ++fail_count;
-      }
+    check_result.last_check_time_str = summary.created_at;
+    check_result.fail_count = summary.fail_count;
+    check_result.success_count = summary.ccu_count - summary.fail_count;
+    check_result.status = summary.fail_count > 0
+                              ? device::SelfCheckStatus::Failed
+                              : device::SelfCheckStatus::Passed;
+    updates.emplace_back(summary.equip_no, std::move(check_result));
+  }
+
+  // 在主线程一次性更新 Model
+  QMetaObject::invokeMethod(
+      device_model,
+      [device_model, updates = std::move(updates)]() {
+        for (const auto &[equip_no, check_result] : updates) {
+          device_model->updateSelfCheck(equip_no, check_result);
+        }
+      },
+      Qt::QueuedConnection);
+
+  LOG(INFO) << "已加载设备最后检测信息: " << result->size() << " 条记录";
+}
+
+// 用本地快照预填充设备列表，数据库未连上之前首页即可显示
+void RestoreDeviceSnapshot(qml_model::DeviceModel *device_model) {
+  auto start = std::chrono::steady_clock::now();
+  auto entries =
+      device::DeviceSnapshot::Load(device::DeviceSnapshot::DefaultPath());
+  if (!entries.ok()) {
+    if (!absl::IsNotFound(entries.status())) {
+      LOG(WARNING) << "读取设备快照失败: " << entries.status().message();
     }
-    check_result.fail_count = fail_count;
-    check_result.success_count =
-        static_cast<int>(ccu_items.size()) - fail_count;
-    if (fail_count > 0) {
-      check_result.status = device::SelfCheckStatus::Failed;
+    return;
+  }
+
+  std::vector<device::PileAttr> attrs;
+  attrs.reserve(entries->size());
+  for (const auto &entry : entries.value()) {
+    attrs.push_back(entry.attrs);
+  }
+  device_model->addDevices(std::move(attrs));
+
+  for (const auto &entry : entries.value()) {
+    const auto &equip_no = entry.attrs.equip_no;
+    device::DeviceStatus status;
+    status.online_state = entry.online_state;
+    device_model->updateStatus(equip_no, status);
+    if (entry.last_check.status != device::SelfCheckStatus::NotRun ||
+        !entry.last_check.last_check_time_str.empty()) {
+      device_model->updateSelfCheck(equip_no, entry.last_check);
     }
+  }
 
-    // 在主线程更新 Model
-    QMetaObject::invokeMethod(
-        device_model,
-        [device_model, equip_no, check_result]() {
-          device_model->updateSelfCheck(equip_no, check_result);
-        },
-        Qt::QueuedConnection);
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  LOG(INFO) << "已从快照恢复设备 " << entries->size() << " 个，耗时 "
+            << elapsed.count() << " us";
+}
+
+// 保存设备快照；设备列表为空时不覆盖旧快照（数据库不可用时启动不应清空缓存）
+void SaveDeviceSnapshot(qml_model::DeviceModel *device_model, bool async) {
+  auto entries = device::DeviceSnapshot::Capture(device_model->allDevices());
+  if (entries.empty()) {
+    return;
+  }
 
-    DLOG(INFO) << "已加载设备最后检测信息: " << equip_no
-               << ", 时间: " << check_result.last_check_time_str;
+  auto save = [entries = std::move(entries)]() {
+    auto status = device::DeviceSnapshot::Save(
+        device::DeviceSnapshot::DefaultPath(), entries);
+    if (!status.ok()) {
+      LOG(WARNING) << "保存设备快照失败: " << status.message();
+    } else {
+      VLOG(1) << "已保存设备快照: " << entries.size() << " 个设备";
+    }
+  };
+
+  if (async) {
+    // 复制出的快照在后台写盘，不阻塞 UI 线程
+    (void)QtConcurrent::run(std::move(save));
+  } else {
+    save();
   }
 }
 
+// 后台分批回填故障摘要列：每批单独提交、完成后再提交下一批，
+// 不长期占用数据库线程；退出事件循环后不再提交，关闭时只需等待当前批次
+void BackfillFaultSummaries(QObject *context) {
+  auto *watcher = new QFutureWatcher<absl::StatusOr<bool>>(context);
+  QObject::connect(
+      watcher, &QFutureWatcher<absl::StatusOr<bool>>::finished, context,
+      [watcher, context]() {
+        watcher->deleteLater();
+        auto result = watcher->future().result();
+        if (!result.ok()) {
+          // 进度已持久化，下次启动从断点继续
+          LOG(WARNING) << "回填故障摘要失败: " << result.status().message();
+          return;
+        }
+        if (*result) {
+          QTimer::singleShot(0, context,
+                             [context]() { BackfillFaultSummaries(context); });
+        }
+      });
+  watcher->setFuture(db::DbExecutor::Submit(
+      db::QueryPriority::kBackground, []() -> absl::StatusOr<bool> {
+        db::ScopedQueryOrigin origin("FaultBackfill");
+        return db::BackfillFaultSummaryBatch();
+      }));
+}
+
 void AsyncLoadDevices(qml_model::DeviceModel *device_model,
                       EAutoCheck::CheckManager *check_manager,
-                      watcher::OnlineStatusWatcher *online_watcher) {
-  std::thread([device_model, check_manager, online_watcher]() {
+                      watcher::OnlineStatusWatcher *online_watcher,
+                      watcher::DeviceSyncWatcher *sync_watcher) {
+  std::thread([device_model, check_manager, online_watcher, sync_watcher]() {
     if (auto status = InitClient(); !status.ok()) {
       LOG(ERROR) << "初始化客户端失败: " << status.message();
       return;
@@ -122,26 +214,51 @@ void AsyncLoadDevices(qml_model::DeviceModel *device_model,
       return;
     }
 
-    const auto &devices = devices_result.value();
+    auto devices = std::move(devices_result).value();
     LOG(INFO) << "加载设备成功，共 " << devices.size() << " 个";
 
-    // 先将设备添加到 Model
-    QMetaObject::invokeMethod(device_model,
-                              [device_model, devices, online_watcher]() {
-                                for (const auto &device : devices) {
-                                  device_model->addDevice(device);
-                                }
-                                LOG(INFO) << "已将设备添加到管理器";
-
-                                // 设备加载完成后，启动在线状态监控
-                                if (online_watcher != nullptr) {
-                                  online_watcher->start();
-                                }
-                              });
-
-    // 在后台线程加载每个设备的最后检测信息
-    LoadLatestCheckInfo(device_model, devices);
-    LOG(INFO) << "已加载所有设备的最后检测信息";
+    // UI 线程对账与后台加载检测信息共用同一份编号集合
+    auto loaded = std::make_shared<std::unordered_set<std::string>>();
+    loaded->reserve(devices.size());
+    for (const auto &device : devices) {
+      loaded->insert(device.equip_no);
+    }
+
+    // 设备列表整体移交给 UI 线程，一次插入通知添加到 Model，并与快照
+    // 预填充的列表对账：已存在的设备原地更新属性，数据库中已删除的设备移除
+    QMetaObject::invokeMethod(
+        device_model,
+        [device_model, devices = std::move(devices), loaded, online_watcher,
+         sync_watcher]() mutable {
+          device_model->addDevices(std::move(devices));
+          for (const auto &device : device_model->allDevices()) {
+            if (loaded->count(device->Id()) == 0) {
+              device_model->removeDevice(device->Id());
+            }
+          }
+          LOG(INFO) << "已将设备添加到管理器";
+          SaveDeviceSnapshot(device_model, true);
+
+          // 设备加载完成后，启动在线状态监控
+          if (online_watcher != nullptr) {
+            online_watcher->start();
+          }
+          // 之后 equipment_info 的变化增量同步
+          if (sync_watcher != nullptr) {
+            sync_watcher->start();
+          }
+          // 迁移 v2 之前的存量记录在后台补齐故障摘要
+          BackfillFaultSummaries(device_model);
+        });
+
+    // 以后台优先级在数据库线程池加载每个设备的最后检测信息，
+    // UI 交互触发的查询可以插队
+    db::DbExecutor::Submit(db::QueryPriority::kBackground,
+                           [device_model, loaded = std::move(loaded)]() {
+                             db::ScopedQueryOrigin origin("Startup");
+                             LoadLatestCheckInfo(device_model, *loaded);
+                             LOG(INFO) << "已加载所有设备的最后检测信息";
+                           });
   }).detach();
 }
 
@@ -157,6 +274,17 @@ int main(int argc, char *argv[]) {
   auto *device_model = new qml_model::DeviceModel(&app);
   qmlRegisterSingletonInstance("EAutoCheck", 1, 0, "DeviceModel", device_model);
 
+  // 首页使用的过滤/排序视图，随 DeviceModel 增量更新
+  auto *device_filter_model =
+      new qml_model::DeviceFilterModel(device_model, &app);
+  qmlRegisterSingletonInstance("EAutoCheck", 1, 0, "DeviceFilterModel",
+                               device_filter_model);
+
+  // 按站点分组的设备树，站点计数随 DeviceModel 增量维护
+  auto *station_model = new qml_model::StationModel(device_model, &app);
+  qmlRegisterSingletonInstance("EAutoCheck", 1, 0, "StationModel",
+                               station_model);
+
   auto *check_manager = new EAutoCheck::CheckManager(device_model, &app);
   qmlRegisterSingletonInstance("EAutoCheck", 1, 0, "CheckManager",
                                check_manager);
@@ -164,25 +292,63 @@ int main(int argc, char *argv[]) {
   auto *history_model = new qml_model::HistoryModel(&app);
   qmlRegisterSingletonInstance("EAutoCheck", 1, 0, "HistoryModel",
                                history_model);
+  // 新自检记录直接推送到历史页，不再整页重新查询
+  QObject::connect(check_manager,
+                   &EAutoCheck::CheckManager::historyRecordSaved,
+                   history_model, &qml_model::HistoryModel::prependRecord);
 
   auto *pile_model = new qml_model::PileModel(&app);
   qmlRegisterSingletonInstance("EAutoCheck", 1, 0, "PileModel", pile_model);
 
+  // 可见 / 悬停 / 最近查看的设备详情后台预热进 CcuDetailCache
+  auto *detail_prefetcher = new device::DetailPrefetcher(&app);
+  qmlRegisterSingletonInstance("EAutoCheck", 1, 0, "DetailPrefetcher",
+                               detail_prefetcher);
+  QObject::connect(check_manager,
+                   &EAutoCheck::CheckManager::historyRecordSaved,
+                   detail_prefetcher,
+                   [detail_prefetcher](const qml_model::HistoryItem &item,
+                                       const QString &, const QString &) {
+                     detail_prefetcher->onRecordSaved(item.deviceId);
+                   });
+
   // 创建在线状态监控器，默认 5 秒轮询一次
   auto *online_watcher = new watcher::OnlineStatusWatcher(device_model, &app);
   online_watcher->setPollIntervalMs(5000);
   qmlRegisterSingletonInstance("EAutoCheck", 1, 0, "OnlineStatusWatcher",
                                online_watcher);
 
+  // 在加载 QML 之前同步恢复快照，首帧即可显示设备
+  RestoreDeviceSnapshot(device_model);
+
+  // 周期性保存快照，保留最近的自检结果与在线状态
+  auto *snapshot_timer = new QTimer(&app);
+  snapshot_timer->setInterval(std::chrono::minutes(5));
+  QObject::connect(snapshot_timer, &QTimer::timeout, device_model,
+                   [device_model]() { SaveDeviceSnapshot(device_model, true); });
+  snapshot_timer->start();
+
+  // 设备表增量同步，默认 60 秒检查一次，有变化时刷新本地快照
+  auto *sync_watcher = new watcher::DeviceSyncWatcher(device_model, &app);
+  sync_watcher->setSyncIntervalMs(60000);
+  QObject::connect(sync_watcher, &watcher::DeviceSyncWatcher::devicesSynced,
+                   device_model, [device_model](int, int, int) {
+                     SaveDeviceSnapshot(device_model, true);
+                   });
+
   QQuickStyle::setStyle("Material");
   engine.loadFromModule("GUI", "Main");
 
   if (engine.rootObjects().isEmpty())
     return -1;
 
-  AsyncLoadDevices(device_model, check_manager, online_watcher);
+  AsyncLoadDevices(device_model, check_manager, online_watcher, sync_watcher);
 
   int ret = QGuiApplication::exec();
+  QThreadPool::globalInstance()->waitForDone(); // 等待进行中的快照写盘
+  SaveDeviceSnapshot(device_model, false);
+  LOG(INFO) << device::CcuDetailCache::Instance().report();
+  db::PartitionMaintainer::Shutdown();
   db::MySqlClient::Shutdown();
   return ret;
 }
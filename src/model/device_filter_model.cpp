@@ -0,0 +1,581 @@
+#include "model/device_filter_model.h"
+
+#include <algorithm>
+
+#include "model/device_model.h"
+
+namespace qml_model {
+
+namespace {
+// 超过该数量的批量插入直接整体重建，比逐行插入更快
+constexpr int kBulkInsertThreshold = 64;
+
+std::u16string ToKey(const QString &text) {
+  const QString lower = text.trimmed().toLower();
+  return {reinterpret_cast<const char16_t *>(lower.utf16()),
+          static_cast<std::size_t>(lower.size())};
+}
+
+bool IsSeparator(char16_t c) {
+  return c == u' ' || c == u'-' || c == u'_' || c == u'#' || c == u'/' ||
+         c == u'(' || c == u')' || c == u'（' || c == u'）';
+}
+
+// 整串 + 按分隔符切出的每个词，例如 "A区-3号桩" -> {"a区-3号桩", "3号桩"}
+void AppendKeys(const std::string &text, std::vector<std::u16string> &keys) {
+  const std::u16string full = ToKey(QString::fromStdString(text));
+  if (full.empty()) {
+    return;
+  }
+  keys.push_back(full);
+  for (std::size_t i = 1; i < full.size(); ++i) {
+    if (IsSeparator(full[i - 1]) && !IsSeparator(full[i])) {
+      keys.push_back(full.substr(i));
+    }
+  }
+}
+
+// 故障等级 > 最后自检结果 > 失败模块数，打包成一个整数便于比较
+int Severity(const device::PileDevice &device) {
+  const auto &check = device.LastSelfCheck();
+  int check_rank = 0;
+  if (check.status == device::SelfCheckStatus::Failed) {
+    check_rank = 2;
+  } else if (check.status == device::SelfCheckStatus::Partial) {
+    check_rank = 1;
+  }
+  const int level = static_cast<int>(device.Status().fault_level);
+  return (level << 16) | (check_rank << 12) |
+         std::clamp(check.fail_count, 0, 0xFFF);
+}
+} // namespace
+
+DeviceFilterModel::DeviceFilterModel(DeviceModel *source, QObject *parent)
+    : QAbstractListModel(parent), source_(source) {
+  connect(source_, &QAbstractItemModel::rowsInserted, this,
+          &DeviceFilterModel::onRowsInserted);
+  connect(source_, &QAbstractItemModel::rowsAboutToBeRemoved, this,
+          &DeviceFilterModel::onRowsAboutToBeRemoved);
+  connect(source_, &QAbstractItemModel::dataChanged, this,
+          &DeviceFilterModel::onDataChanged);
+  connect(source_, &QAbstractItemModel::modelReset, this,
+          &DeviceFilterModel::rebuildFromSource);
+  connect(source_, &QAbstractItemModel::layoutChanged, this,
+          &DeviceFilterModel::rebuildFromSource);
+  rebuildFromSource();
+}
+
+int DeviceFilterModel::rowCount(const QModelIndex &parent) const {
+  if (parent.isValid())
+    return 0;
+  return count();
+}
+
+QVariant DeviceFilterModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid() || index.row() >= count())
+    return {};
+  // 句柄 -> 源行号为 O(1) 数组访问
+  const int source_row = source_->snapshot()->rowOf(visible_[index.row()]);
+  if (source_row < 0)
+    return {};
+  return source_->data(source_->index(source_row), role);
+}
+
+QHash<int, QByteArray> DeviceFilterModel::roleNames() const {
+  return source_->roleNames();
+}
+
+// ============ 过滤 / 排序条件 ============
+void DeviceFilterModel::setSearchText(const QString &text) {
+  if (search_text_ == text)
+    return;
+  search_text_ = text;
+  refilter();
+  emit filterChanged();
+}
+
+void DeviceFilterModel::setStationNo(const QString &station_no) {
+  if (station_no_ == station_no)
+    return;
+  station_no_ = station_no;
+  refilter();
+  emit filterChanged();
+}
+
+void DeviceFilterModel::setOfflineOnly(bool value) {
+  if (offline_only_ == value)
+    return;
+  offline_only_ = value;
+  refilter();
+  emit filterChanged();
+}
+
+void DeviceFilterModel::setFailedOnly(bool value) {
+  if (failed_only_ == value)
+    return;
+  failed_only_ = value;
+  refilter();
+  emit filterChanged();
+}
+
+void DeviceFilterModel::setSortKey(SortKey key) {
+  if (sort_key_ == key)
+    return;
+  sort_key_ = key;
+  resort();
+  emit sortChanged();
+}
+
+void DeviceFilterModel::setSortDescending(bool value) {
+  if (sort_descending_ == value)
+    return;
+  sort_descending_ = value;
+  resort();
+  emit sortChanged();
+}
+
+void DeviceFilterModel::clearFilters() {
+  search_text_.clear();
+  station_no_.clear();
+  offline_only_ = false;
+  failed_only_ = false;
+  refilter();
+  emit filterChanged();
+}
+
+// ============ 缓存字段 ============
+DeviceFilterModel::Entry
+DeviceFilterModel::MakeEntry(const device::PileDevice &device) {
+  const auto &attrs = device.Attributes();
+  Entry entry;
+  entry.present = true;
+  entry.name_key = QString::fromStdString(attrs.name).toLower();
+  entry.equip_no = attrs.equip_no;
+  entry.station_no = attrs.station_no;
+  entry.last_check = device.LastCheckTime();
+  entry.severity = Severity(device);
+  entry.online = device.IsOnline();
+  entry.failed =
+      device.LastSelfCheck().status == device::SelfCheckStatus::Failed;
+  AppendKeys(attrs.name, entry.search_keys);
+  AppendKeys(attrs.name_en, entry.search_keys);
+  AppendKeys(attrs.equip_no, entry.search_keys);
+  std::sort(entry.search_keys.begin(), entry.search_keys.end());
+  entry.search_keys.erase(
+      std::unique(entry.search_keys.begin(), entry.search_keys.end()),
+      entry.search_keys.end());
+  return entry;
+}
+
+bool DeviceFilterModel::storeEntry(device::DeviceHandle handle,
+                                   Entry &&entry) {
+  if (entries_.size() <= handle) {
+    entries_.resize(handle + 1);
+    text_match_.resize(handle + 1, 0);
+  }
+  auto &slot = entries_[handle];
+
+  // 名称 / 编号不变时（绝大多数状态更新）不动前缀树
+  if (!slot.present || slot.search_keys != entry.search_keys) {
+    for (const auto &key : slot.search_keys) {
+      trie_.erase(key, handle);
+    }
+    for (const auto &key : entry.search_keys) {
+      trie_.insert(key, handle);
+    }
+  }
+
+  bool stations_changed = false;
+  if (!slot.present || slot.station_no != entry.station_no) {
+    if (slot.present && --station_counts_[slot.station_no] == 0) {
+      station_counts_.erase(slot.station_no);
+      stations_changed = true;
+    }
+    if (station_counts_[entry.station_no]++ == 0) {
+      stations_changed = true;
+    }
+  }
+
+  slot = std::move(entry);
+  text_match_[handle] = has_text_filter_ && matchesText(slot) ? 1 : 0;
+
+  return stations_changed;
+}
+
+bool DeviceFilterModel::dropEntry(device::DeviceHandle handle) {
+  if (handle >= entries_.size() || !entries_[handle].present)
+    return false;
+  auto &slot = entries_[handle];
+  for (const auto &key : slot.search_keys) {
+    trie_.erase(key, handle);
+  }
+  bool stations_changed = false;
+  if (--station_counts_[slot.station_no] == 0) {
+    station_counts_.erase(slot.station_no);
+    stations_changed = true;
+  }
+  slot = Entry();
+  text_match_[handle] = 0;
+  return stations_changed;
+}
+
+QStringList DeviceFilterModel::stations() const {
+  QStringList stations;
+  stations.reserve(static_cast<int>(station_counts_.size()));
+  for (const auto &[station, n] : station_counts_) {
+    stations.append(QString::fromStdString(station));
+  }
+  return stations;
+}
+
+// ============ 比较与过滤 ============
+bool DeviceFilterModel::less(device::DeviceHandle a,
+                             device::DeviceHandle b) const {
+  const auto &ea = entries_[a];
+  const auto &eb = entries_[b];
+  int c = 0;
+  switch (sort_key_) {
+  case SortByName:
+    c = ea.name_key.compare(eb.name_key);
+    break;
+  case SortBySeverity:
+    c = ea.severity < eb.severity ? -1 : (ea.severity > eb.severity ? 1 : 0);
+    break;
+  case SortByLastCheck:
+    c = ea.last_check.compare(eb.last_check);
+    break;
+  }
+  if (c != 0) {
+    return sort_descending_ ? c > 0 : c < 0;
+  }
+  // 次序键固定升序，保证全序（定位某一行时可二分）
+  if (ea.equip_no != eb.equip_no) {
+    return ea.equip_no < eb.equip_no;
+  }
+  return a < b;
+}
+
+bool DeviceFilterModel::matchesText(const Entry &entry) const {
+  return std::any_of(entry.search_keys.begin(), entry.search_keys.end(),
+                     [this](const std::u16string &key) {
+                       return key.compare(0, text_key_.size(), text_key_) == 0;
+                     });
+}
+
+bool DeviceFilterModel::accepts(device::DeviceHandle handle) const {
+  const auto &entry = entries_[handle];
+  if (offline_only_ && entry.online)
+    return false;
+  if (failed_only_ && !entry.failed)
+    return false;
+  if (!station_key_.empty() && entry.station_no != station_key_)
+    return false;
+  if (has_text_filter_ && text_match_[handle] == 0)
+    return false;
+  return true;
+}
+
+std::size_t
+DeviceFilterModel::lowerBound(const std::vector<device::DeviceHandle> &seq,
+                              device::DeviceHandle handle) const {
+  auto it = std::lower_bound(
+      seq.begin(), seq.end(), handle,
+      [this](device::DeviceHandle a, device::DeviceHandle b) {
+        return less(a, b);
+      });
+  return static_cast<std::size_t>(it - seq.begin());
+}
+
+void DeviceFilterModel::updateTextMatches() {
+  text_key_ = ToKey(search_text_);
+  std::fill(text_match_.begin(), text_match_.end(), 0);
+  const auto *ids = trie_.find(text_key_);
+  has_text_filter_ = ids != nullptr;
+  if (ids == nullptr)
+    return;
+  for (const auto handle : *ids) {
+    text_match_[handle] = 1;
+  }
+}
+
+// ============ 重建 ============
+void DeviceFilterModel::sortOrder() {
+  std::sort(order_.begin(), order_.end(),
+            [this](device::DeviceHandle a, device::DeviceHandle b) {
+              return less(a, b);
+            });
+}
+
+std::vector<device::DeviceHandle> DeviceFilterModel::filterOrder() const {
+  std::vector<device::DeviceHandle> visible;
+  visible.reserve(order_.size());
+  // order_ 已有序，线性扫描即可，不需要排序
+  for (const auto handle : order_) {
+    if (accepts(handle)) {
+      visible.push_back(handle);
+    }
+  }
+  return visible;
+}
+
+void DeviceFilterModel::mergeVisible(
+    std::vector<device::DeviceHandle> &&next) {
+  const int old_count = count();
+
+  // 沿 order_ 同步走新旧两个子序列：只在旧序列中的行删除，只在新序列中的行
+  // 插入，两者都有的行保持不动；同类的相邻行合并为一次通知
+  enum class Run { kNone, kRemove, kInsert };
+  Run run = Run::kNone;
+  int run_row = 0; // 当前区间在 visible_ 中的起始行
+  std::vector<device::DeviceHandle> pending; // 待插入的行
+  int pending_removed = 0;
+
+  auto flush = [&]() {
+    if (run == Run::kRemove && pending_removed > 0) {
+      beginRemoveRows(QModelIndex(), run_row, run_row + pending_removed - 1);
+      visible_.erase(visible_.begin() + run_row,
+                     visible_.begin() + run_row + pending_removed);
+      endRemoveRows();
+    } else if (run == Run::kInsert && !pending.empty()) {
+      const int n = static_cast<int>(pending.size());
+      beginInsertRows(QModelIndex(), run_row, run_row + n - 1);
+      visible_.insert(visible_.begin() + run_row, pending.begin(),
+                      pending.end());
+      endInsertRows();
+    }
+    run = Run::kNone;
+    pending.clear();
+    pending_removed = 0;
+  };
+
+  // row 为已处理部分在 visible_ 中的行数（删除在 flush 前不计入）
+  int row = 0;
+  std::size_t old_pos = 0;
+  std::size_t new_pos = 0;
+  const auto old_visible = visible_; // 走位期间 visible_ 会被修改
+  for (const auto handle : order_) {
+    const bool in_old =
+        old_pos < old_visible.size() && old_visible[old_pos] == handle;
+    const bool in_new = new_pos < next.size() && next[new_pos] == handle;
+    if (in_old)
+      ++old_pos;
+    if (in_new)
+      ++new_pos;
+
+    if (in_old && in_new) {
+      flush();
+      ++row;
+    } else if (in_old) {
+      if (run != Run::kRemove) {
+        flush();
+        run = Run::kRemove;
+        run_row = row;
+      }
+      ++pending_removed;
+    } else if (in_new) {
+      if (run != Run::kInsert) {
+        flush();
+        run = Run::kInsert;
+        run_row = row;
+      }
+      pending.push_back(handle);
+      ++row;
+    }
+  }
+  flush();
+
+  if (count() != old_count) {
+    emit countChanged();
+  }
+}
+
+void DeviceFilterModel::refilter() {
+  updateTextMatches();
+  station_key_ = station_no_.toStdString();
+  mergeVisible(filterOrder());
+}
+
+void DeviceFilterModel::resort() {
+  // 过滤条件不变，可见集合不变，只有顺序变化
+  emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+  const QModelIndexList persistent = persistentIndexList();
+  std::vector<device::DeviceHandle> persistent_handles;
+  persistent_handles.reserve(persistent.size());
+  for (const auto &idx : persistent) {
+    persistent_handles.push_back(visible_[idx.row()]);
+  }
+
+  sortOrder();
+  visible_ = filterOrder();
+
+  if (!persistent.isEmpty()) {
+    std::vector<int> row_of(entries_.size(), -1);
+    for (int i = 0; i < count(); ++i) {
+      row_of[visible_[i]] = i;
+    }
+    QModelIndexList moved;
+    moved.reserve(persistent.size());
+    for (std::size_t i = 0; i < persistent_handles.size(); ++i) {
+      const int new_row = row_of[persistent_handles[i]];
+      moved.append(new_row >= 0 ? index(new_row) : QModelIndex());
+    }
+    changePersistentIndexList(persistent, moved);
+  }
+  emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
+
+void DeviceFilterModel::rebuildFromSource() {
+  const auto table = source_->snapshot();
+  beginResetModel();
+  entries_.clear();
+  text_match_.clear();
+  trie_.clear();
+  station_counts_.clear();
+  order_.clear();
+  order_.reserve(table->size());
+  for (int row = 0; row < table->size(); ++row) {
+    const auto device = table->at(row);
+    if (!device)
+      continue;
+    storeEntry(device->Handle(), MakeEntry(*device));
+    order_.push_back(device->Handle());
+  }
+  sortOrder();
+  updateTextMatches();
+  station_key_ = station_no_.toStdString();
+  visible_ = filterOrder();
+  endResetModel();
+  emit countChanged();
+  emit stationsChanged();
+}
+
+// ============ 源模型增量变化 ============
+void DeviceFilterModel::onRowsInserted(const QModelIndex &parent, int first,
+                                       int last) {
+  if (parent.isValid())
+    return;
+  if (last - first + 1 > kBulkInsertThreshold) {
+    rebuildFromSource();
+    return;
+  }
+
+  const auto table = source_->snapshot();
+  bool stations_changed = false;
+  for (int row = first; row <= last; ++row) {
+    const auto device = table->at(row);
+    if (!device)
+      continue;
+    const auto handle = device->Handle();
+    stations_changed |= storeEntry(handle, MakeEntry(*device));
+    order_.insert(order_.begin() + lowerBound(order_, handle), handle);
+    if (accepts(handle)) {
+      const auto pos = static_cast<int>(lowerBound(visible_, handle));
+      beginInsertRows(QModelIndex(), pos, pos);
+      visible_.insert(visible_.begin() + pos, handle);
+      endInsertRows();
+    }
+  }
+  // totalCount 总会变化
+  emit countChanged();
+  if (stations_changed) {
+    emit stationsChanged();
+  }
+}
+
+void DeviceFilterModel::onRowsAboutToBeRemoved(const QModelIndex &parent,
+                                               int first, int last) {
+  if (parent.isValid())
+    return;
+
+  // 此时源模型仍是删除前的表
+  const auto table = source_->snapshot();
+  bool stations_changed = false;
+  for (int row = first; row <= last; ++row) {
+    const auto device = table->at(row);
+    if (!device)
+      continue;
+    const auto handle = device->Handle();
+    if (handle >= entries_.size() || !entries_[handle].present)
+      continue;
+    if (accepts(handle)) {
+      const auto pos = static_cast<int>(lowerBound(visible_, handle));
+      beginRemoveRows(QModelIndex(), pos, pos);
+      visible_.erase(visible_.begin() + pos);
+      endRemoveRows();
+    }
+    order_.erase(order_.begin() + lowerBound(order_, handle));
+    stations_changed |= dropEntry(handle);
+  }
+  emit countChanged();
+  if (stations_changed) {
+    emit stationsChanged();
+  }
+}
+
+void DeviceFilterModel::onDataChanged(const QModelIndex &top_left,
+                                      const QModelIndex &bottom_right,
+                                      const QList<int> &roles) {
+  const auto table = source_->snapshot();
+  const int old_count = count();
+  bool stations_changed = false;
+  for (int row = top_left.row(); row <= bottom_right.row(); ++row) {
+    const auto device = table->at(row);
+    if (!device)
+      continue;
+    const auto handle = device->Handle();
+    if (handle >= entries_.size() || !entries_[handle].present)
+      continue;
+
+    // 先按旧字段定位，再写入新字段
+    const bool was_visible = accepts(handle);
+    const auto old_order = lowerBound(order_, handle);
+    const auto old_row = was_visible ? lowerBound(visible_, handle) : 0;
+
+    stations_changed |= storeEntry(handle, MakeEntry(*device));
+
+    // 全部设备序列：移到新位置
+    order_.erase(order_.begin() + old_order);
+    order_.insert(order_.begin() + lowerBound(order_, handle), handle);
+
+    const bool now_visible = accepts(handle);
+    if (was_visible && now_visible) {
+      visible_.erase(visible_.begin() + old_row);
+      const auto new_row = lowerBound(visible_, handle);
+      visible_.insert(visible_.begin() + old_row, handle);
+      if (new_row != old_row) {
+        const int from = static_cast<int>(old_row);
+        const int to = static_cast<int>(new_row);
+        beginMoveRows(QModelIndex(), from, from, QModelIndex(),
+                      to > from ? to + 1 : to);
+        if (to > from) {
+          std::rotate(visible_.begin() + from, visible_.begin() + from + 1,
+                      visible_.begin() + to + 1);
+        } else {
+          std::rotate(visible_.begin() + to, visible_.begin() + from,
+                      visible_.begin() + from + 1);
+        }
+        endMoveRows();
+      }
+      const QModelIndex idx = index(static_cast<int>(new_row));
+      emit dataChanged(idx, idx, roles);
+    } else if (was_visible) {
+      const int from = static_cast<int>(old_row);
+      beginRemoveRows(QModelIndex(), from, from);
+      visible_.erase(visible_.begin() + from);
+      endRemoveRows();
+    } else if (now_visible) {
+      const auto pos = static_cast<int>(lowerBound(visible_, handle));
+      beginInsertRows(QModelIndex(), pos, pos);
+      visible_.insert(visible_.begin() + pos, handle);
+      endInsertRows();
+    }
+  }
+  if (count() != old_count) {
+    emit countChanged();
+  }
+  if (stations_changed) {
+    emit stationsChanged();
+  }
+}
+
+} // namespace qml_model
@@ -1,27 +1,57 @@
 #include "model/device_model.h"
+#include <algorithm>
 #include <glog/logging.h>
 
 namespace qml_model {
 
-DeviceModel::DeviceModel(QObject *parent) : QAbstractListModel(parent) {}
+// ---------------------------
+// DeviceTable
+// ---------------------------
+DeviceModel::PileDevicePtr DeviceModel::DeviceTable::at(int row) const {
+  if (row < 0 || row >= size())
+    return nullptr;
+  return slots_[row]->device.load();
+}
+
+DeviceModel::PileDevicePtr
+DeviceModel::DeviceTable::find(device::DeviceHandle handle) const {
+  return at(rowOf(handle));
+}
+
+DeviceModel::PileDevicePtr
+DeviceModel::DeviceTable::find(std::string_view equip_no) const {
+  return at(rowOf(equip_no));
+}
+
+int DeviceModel::DeviceTable::rowOf(device::DeviceHandle handle) const {
+  return handle < row_by_handle_.size() ? row_by_handle_[handle] : -1;
+}
+
+int DeviceModel::DeviceTable::rowOf(std::string_view equip_no) const {
+  return rowOf(device::DeviceRegistry::Instance().find(equip_no));
+}
+
+// ---------------------------
+// DeviceModel
+// ---------------------------
+DeviceModel::DeviceModel(QObject *parent)
+    : QAbstractListModel(parent),
+      table_(std::make_shared<const DeviceTable>()) {}
 
 int DeviceModel::rowCount(const QModelIndex &parent) const {
   if (parent.isValid())
     return 0;
-  std::lock_guard<std::mutex> lock(mutex_);
-  return static_cast<int>(device_list_.size());
+  return table_.load()->size();
 }
 
 QVariant DeviceModel::data(const QModelIndex &index, int role) const {
   if (!index.isValid())
     return {};
 
-  std::lock_guard<std::mutex> lock(mutex_);
-  const int row = index.row();
-  if (row < 0 || row >= static_cast<int>(device_list_.size()))
+  const auto device = table_.load()->at(index.row());
+  if (!device)
     return {};
 
-  const auto &device = device_list_[row];
   const auto &attrs = device->Attributes();
 
   switch (role) {
@@ -69,73 +99,72 @@ QHash<int, QByteArray> DeviceModel::roleNames() const {
   return roles;
 }
 
+std::shared_ptr<DeviceModel::DeviceTable> DeviceModel::cloneTable() const {
+  auto next = std::make_shared<DeviceTable>(*table_.load());
+  ++next->version_;
+  return next;
+}
+
+template <typename Fn>
+int DeviceModel::mutateDevice(device::DeviceHandle handle, const char *what,
+                              Fn &&fn) {
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  const auto table = table_.load();
+  const int row = table->rowOf(handle);
+  if (row < 0) {
+    LOG(WARNING) << what << ": device not found, handle=" << handle;
+    return -1;
+  }
+
+  auto &slot = *table->slots_[row];
+  auto next = std::make_shared<device::PileDevice>(*slot.device.load());
+  if (!fn(*next)) {
+    return -1;
+  }
+  slot.device.store(std::move(next));
+  return row;
+}
+
 DeviceModel::PileDevicePtr
 DeviceModel::addDevice(const device::PileAttr &attrs) {
-  // 注意：必须在持有锁之前创建 shared_ptr，但锁的范围需要覆盖 map 和 vector
-  // 操作 因为 addDevice 可能在后台线程调用，而 UI 线程在读取 QAbstractListModel
-  // 的 begin/endInsertRows 只能在 UI 线程调用吗？
-  // 不，它们发出的信号是线程安全的，但是 Model 的内部数据结构必须受保护。
-  // 实际上，如果是在后台线程调用 beginInsertRows，信号连接到 UI
-  // 可能会有跨线程问题。 但 Qt
-  // 的信号槽机制处理了跨线程连接（QueuedConnection）。 最安全的做法是确保
-  // addDevice 也是在主线程调用的（现在的 main.cpp 逻辑正是如此，invokeMethod
-  // 到了主线程）。
+  // begin/endInsertRows 与 dataChanged 必须在 UI 线程调用
+  // （main.cpp 中通过 invokeMethod 投递到主线程），行结构只在 UI 线程变化
 
   DLOG(INFO) << "addDevice: " << attrs;
-  auto device = std::make_shared<device::PileDevice>(attrs);
-  const auto &key = device->Id();
-
-  // 我们需要确保 beginInsertRows/endInsertRows 包裹住数据变更
-  // 但是这一步必须在获取锁的情况下进行吗？
-  // Qt Model 的惯例是：修改数据前调用 begin，修改后调用 end。
-  // 这里的锁是用来保护 device_list_ 和 device_map_ 的。
-
-  // 检查是否存在
-  {
-    // 先检查是否存在，如果存在则是更新操作
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = device_map_.find(key);
-    if (it != device_map_.end()) {
-      // 已存在，更新（替换）
-      // 找到在 list 中的位置
-      for (size_t i = 0; i < device_list_.size(); ++i) {
-        if (device_list_[i]->Id() == key) {
-          device_list_[i] = device;
-          device_map_[key] = device;
-          // 释放锁后发送信号？不，dataChanged
-          // 是信号，可以在锁内发，但最好尽早释放
-          // 这里简单处理，锁内发也没事，因为是 invokeMethod 调用的，在主线程
-          QModelIndex idx = index(static_cast<int>(i));
-          // const_cast 因为 dataChanged 是非 const 的，但在 const
-          // 成员函数中不能调？ addDevice 不是 const 的，没问题。
-          // 但由于我们手动加了锁，要小心死锁。这里没调外部代码，安全。
-          const_cast<DeviceModel *>(this)->dataChanged(idx, idx);
-          LOG(INFO) << "Device updated: " << key;
-          return device;
-        }
-      }
+  const auto &key = attrs.equip_no;
+  const auto handle = device::DeviceRegistry::Instance().intern(attrs);
+
+  // 已存在：原地更新属性，保留在线状态与自检结果
+  // （快照预填充的设备在数据库加载后走这里，不能丢失运行时状态）
+  if (table_.load()->rowOf(handle) >= 0) {
+    const int row =
+        mutateDevice(handle, "addDevice", [&](device::PileDevice &d) {
+          d.UpdateAttributes(attrs);
+          return true;
+        });
+    if (row >= 0) {
+      QModelIndex idx = index(row);
+      emit dataChanged(idx, idx);
+      LOG(INFO) << "Device updated: " << key;
     }
+    return table_.load()->find(handle);
   }
 
-  // 是新设备
-  // beginInsertRows 会触发 View 的响应，View 会尝试 lock rowCount/data
-  // 所以 beginInsertRows 应该在 lock 之外？
-  // 不，beginInsertRows 只是发信号通知 "将要插入"。
-  // 真正的数据插入应该在 begin 和 end 之间。
-  // 如果在 begin 和 end 之间，View 试图访问怎么办？
-  // 通常 View 只在 endInsertRows 之后（收到 rowsInserted 信号）才会刷新。
-
-  int row = 0;
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    row = static_cast<int>(device_list_.size());
+  // 是新设备：View 在 endInsertRows 之后才会读取新行
+  PileDevicePtr device =
+      std::make_shared<const device::PileDevice>(attrs, handle);
+  auto next = cloneTable();
+  const int row = next->size();
+  next->slots_.push_back(std::make_shared<DeviceTable::Slot>(device));
+  if (next->row_by_handle_.size() <= handle) {
+    next->row_by_handle_.resize(handle + 1, -1);
   }
+  next->row_by_handle_[handle] = row;
 
   beginInsertRows(QModelIndex(), row, row);
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    device_list_.push_back(device);
-    device_map_[key] = device;
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    table_.store(std::move(next));
   }
   endInsertRows();
 
@@ -143,158 +172,213 @@ DeviceModel::addDevice(const device::PileAttr &attrs) {
   return device;
 }
 
-DeviceModel::PileDevicePtr
-DeviceModel::getDeviceByEquipNo(const std::string &equip_no) const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto it = device_map_.find(equip_no);
-  if (it == device_map_.end()) {
-    return nullptr;
+int DeviceModel::addDevices(std::vector<device::PileAttr> &&attrs) {
+  if (attrs.empty()) {
+    return 0;
   }
-  return it->second;
-}
-
-bool DeviceModel::hasDevice(const std::string &equip_no) const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  return device_map_.find(equip_no) != device_map_.end();
-}
-
-std::vector<DeviceModel::PileDevicePtr> DeviceModel::allDevices() const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  // 直接拷贝 vector
-  return device_list_;
-}
+  auto &registry = device::DeviceRegistry::Instance();
 
-void DeviceModel::updateStatus(const std::string &equip_no,
-                               const device::DeviceStatus &status) {
-  // 这里需要通知 Model 更新
-  int row = -1;
+  auto next = cloneTable();
+  const int first = next->size();
+  std::vector<int> updated_rows;
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = device_map_.find(equip_no);
-    if (it == device_map_.end()) {
-      LOG(WARNING) << "updateStatus: device not found, equip_no=" << equip_no;
-      return;
-    }
-    it->second->UpdateStatus(status);
-
-    // 查找 row index 以发送信号
-    // 简单的线性查找
-    for (size_t i = 0; i < device_list_.size(); ++i) {
-      if (device_list_[i]->Id() == equip_no) {
-        row = static_cast<int>(i);
-        break;
+    // 已存在设备的属性在同一把锁内更新，不逐台加锁
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    for (const auto &attr : attrs) {
+      const auto handle = registry.intern(attr);
+      if (next->row_by_handle_.size() <= handle) {
+        next->row_by_handle_.resize(handle + 1, -1);
+      }
+      const int row = next->row_by_handle_[handle];
+      if (row < 0) {
+        next->row_by_handle_[handle] = next->size();
+        next->slots_.push_back(std::make_shared<DeviceTable::Slot>(
+            std::make_shared<const device::PileDevice>(attr, handle)));
+        continue;
+      }
+      // 槽位与当前表共享：旧表的读者同样看到新属性
+      auto &slot = *next->slots_[row];
+      auto device = std::make_shared<device::PileDevice>(*slot.device.load());
+      device->UpdateAttributes(attr);
+      slot.device.store(std::move(device));
+      if (row < first) {
+        updated_rows.push_back(row);
       }
     }
   }
 
-  if (row >= 0) {
-    QModelIndex idx = index(row);
-    // 仅通知状态相关的 Role 发生了变化
-    emit dataChanged(idx, idx, {StatusRole, IsOnlineRole});
+  const int added = next->size() - first;
+  if (added > 0) {
+    // View 在 endInsertRows 之后才会读取新行
+    beginInsertRows(QModelIndex(), first, next->size() - 1);
+    {
+      std::lock_guard<std::mutex> lock(write_mutex_);
+      table_.store(std::move(next));
+    }
+    endInsertRows();
   }
-}
 
-void DeviceModel::updateSelfCheck(const std::string &equip_no,
-                                  const device::SelfCheckResult &result) {
-  int row = -1;
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = device_map_.find(equip_no);
-    if (it == device_map_.end()) {
-      LOG(WARNING) << "updateSelfCheck: device not found, equip_no="
-                   << equip_no;
-      return;
+  std::sort(updated_rows.begin(), updated_rows.end());
+  for (std::size_t i = 0; i < updated_rows.size();) {
+    std::size_t j = i + 1;
+    while (j < updated_rows.size() &&
+           updated_rows[j] <= updated_rows[j - 1] + 1) {
+      ++j;
     }
-    it->second->UpdateSelfCheck(result);
+    emit dataChanged(index(updated_rows[i]), index(updated_rows[j - 1]));
+    i = j;
+  }
 
-    // 查找 row index 以发送信号
-    for (size_t i = 0; i < device_list_.size(); ++i) {
-      if (device_list_[i]->Id() == equip_no) {
-        row = static_cast<int>(i);
-        break;
-      }
-    }
+  LOG(INFO) << "Devices added: " << added
+            << ", updated: " << static_cast<int>(attrs.size()) - added;
+  return added;
+}
+
+bool DeviceModel::removeDevice(const std::string &equip_no) {
+  const auto handle = device::DeviceRegistry::Instance().find(equip_no);
+  const int row = table_.load()->rowOf(handle);
+  if (row < 0) {
+    return false;
   }
 
-  if (row >= 0) {
-    QModelIndex idx = index(row);
-    // 通知最后自检时间相关的 Role 发生了变化
-    emit dataChanged(idx, idx, {LastCheckTimeRole, StatusTextRole});
+  auto next = cloneTable();
+  next->slots_.erase(next->slots_.begin() + row);
+  next->row_by_handle_[handle] = -1;
+  // 删除较少发生，后续行整体前移一位
+  for (int i = row; i < next->size(); ++i) {
+    next->row_by_handle_[next->slots_[i]->device.load()->Handle()] = i;
   }
-}
 
-void DeviceModel::updateSelfCheckProgress(const std::string &equip_no,
-                                          const std::string &desc,
-                                          bool is_checking) {
-  int row = -1;
+  beginRemoveRows(QModelIndex(), row, row);
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = device_map_.find(equip_no);
-    if (it == device_map_.end()) {
-      LOG(WARNING) << "updateSelfCheckProgress: device not found, equip_no="
-                   << equip_no;
-      return;
-    }
-    it->second->UpdateSelfCheckProgress(desc, is_checking);
-
-    // 查找 row index 以发送信号
-    for (size_t i = 0; i < device_list_.size(); ++i) {
-      if (device_list_[i]->Id() == equip_no) {
-        row = static_cast<int>(i);
-        break;
-      }
-    }
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    table_.store(std::move(next));
   }
+  endRemoveRows();
 
-  if (row >= 0) {
-    QModelIndex idx = index(row);
-    // 通知状态文本和检查状态相关的 Role 发生了变化
-    emit dataChanged(idx, idx, {StatusTextRole, IsCheckingRole});
+  LOG(INFO) << "Device removed: " << equip_no;
+  return true;
+}
+
+DeviceModel::PileDevicePtr
+DeviceModel::getDeviceByEquipNo(const std::string &equip_no) const {
+  return table_.load()->find(equip_no);
+}
+
+DeviceModel::PileDevicePtr
+DeviceModel::getDevice(device::DeviceHandle handle) const {
+  return table_.load()->find(handle);
+}
+
+bool DeviceModel::hasDevice(const std::string &equip_no) const {
+  return table_.load()->rowOf(equip_no) >= 0;
+}
+
+std::vector<DeviceModel::PileDevicePtr> DeviceModel::allDevices() const {
+  const auto table = table_.load();
+  std::vector<PileDevicePtr> devices;
+  devices.reserve(table->size());
+  for (int row = 0; row < table->size(); ++row) {
+    devices.push_back(table->at(row));
   }
+  return devices;
 }
 
-void DeviceModel::updateOnlineStatus(const std::string &equip_no,
-                                     bool is_online) {
-  int row = -1;
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = device_map_.find(equip_no);
-    if (it == device_map_.end()) {
-      LOG(WARNING) << "updateOnlineStatus: device not found, equip_no="
-                   << equip_no;
-      return;
-    }
+void DeviceModel::updateStatus(device::DeviceHandle handle,
+                               const device::DeviceStatus &status) {
+  const int row =
+      mutateDevice(handle, "updateStatus", [&](device::PileDevice &d) {
+        d.UpdateStatus(status);
+        return true;
+      });
+  if (row < 0)
+    return;
+
+  QModelIndex idx = index(row);
+  // 仅通知状态相关的 Role 发生了变化
+  emit dataChanged(idx, idx, {StatusRole, IsOnlineRole});
+}
 
-    // 获取当前状态，仅修改在线字段
-    device::DeviceStatus status = it->second->Status();
-    device::OnlineState new_state =
-        is_online ? device::OnlineState::Online : device::OnlineState::Offline;
+void DeviceModel::updateSelfCheck(device::DeviceHandle handle,
+                                  const device::SelfCheckResult &result) {
+  const int row =
+      mutateDevice(handle, "updateSelfCheck", [&](device::PileDevice &d) {
+        d.UpdateSelfCheck(result);
+        return true;
+      });
+  if (row < 0)
+    return;
+
+  QModelIndex idx = index(row);
+  // 通知最后自检时间相关的 Role 发生了变化
+  emit dataChanged(idx, idx, {LastCheckTimeRole, StatusTextRole});
+}
 
-    // 只有状态变化时才更新
-    if (status.online_state == new_state) {
-      return;
-    }
+void DeviceModel::updateSelfCheckProgress(device::DeviceHandle handle,
+                                          const std::string &desc,
+                                          bool is_checking) {
+  const int row = mutateDevice(handle, "updateSelfCheckProgress",
+                               [&](device::PileDevice &d) {
+                                 d.UpdateSelfCheckProgress(desc, is_checking);
+                                 return true;
+                               });
+  if (row < 0)
+    return;
+
+  QModelIndex idx = index(row);
+  // 通知状态文本和检查状态相关的 Role 发生了变化
+  emit dataChanged(idx, idx, {StatusTextRole, IsCheckingRole});
+}
 
-    status.online_state = new_state;
-    status.last_update = std::chrono::system_clock::now();
-    it->second->UpdateStatus(status);
+void DeviceModel::updateOnlineStatus(device::DeviceHandle handle,
+                                     bool is_online) {
+  const device::OnlineState new_state =
+      is_online ? device::OnlineState::Online : device::OnlineState::Offline;
+
+  const int row = mutateDevice(
+      handle, "updateOnlineStatus", [&](device::PileDevice &d) {
+        // 获取当前状态，仅修改在线字段；只有状态变化时才更新
+        device::DeviceStatus status = d.Status();
+        if (status.online_state == new_state) {
+          return false;
+        }
+        status.online_state = new_state;
+        status.last_update = std::chrono::system_clock::now();
+        d.UpdateStatus(status);
+        return true;
+      });
+  if (row < 0)
+    return;
+
+  QModelIndex idx = index(row);
+  // 仅通知在线状态相关的 Role 发生了变化
+  emit dataChanged(idx, idx, {IsOnlineRole, StatusTextRole});
+  DLOG(INFO) << "Device " << handle << " online status changed to: "
+             << (is_online ? "Online" : "Offline");
+}
 
-    // 查找 row index 以发送信号
-    for (size_t i = 0; i < device_list_.size(); ++i) {
-      if (device_list_[i]->Id() == equip_no) {
-        row = static_cast<int>(i);
-        break;
-      }
-    }
-  }
+// equip_no 重载：查一次注册表（string_view 查找，不复制）后转到句柄版本
+void DeviceModel::updateStatus(const std::string &equip_no,
+                               const device::DeviceStatus &status) {
+  updateStatus(device::DeviceRegistry::Instance().find(equip_no), status);
+}
 
-  if (row >= 0) {
-    QModelIndex idx = index(row);
-    // 仅通知在线状态相关的 Role 发生了变化
-    emit dataChanged(idx, idx, {IsOnlineRole, StatusTextRole});
-    DLOG(INFO) << "Device " << equip_no << " online status changed to: "
-               << (is_online ? "Online" : "Offline");
-  }
+void DeviceModel::updateSelfCheck(const std::string &equip_no,
+                                  const device::SelfCheckResult &result) {
+  updateSelfCheck(device::DeviceRegistry::Instance().find(equip_no), result);
+}
+
+void DeviceModel::updateSelfCheckProgress(const std::string &equip_no,
+                                          const std::string &desc,
+                                          bool is_checking) {
+  updateSelfCheckProgress(device::DeviceRegistry::Instance().find(equip_no),
+                          desc, is_checking);
+}
+
+void DeviceModel::updateOnlineStatus(const std::string &equip_no,
+                                     bool is_online) {
+  updateOnlineStatus(device::DeviceRegistry::Instance().find(equip_no),
+                     is_online);
 }
 
 } // namespace qml_model
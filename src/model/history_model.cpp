@@ -1,13 +1,16 @@
 #include "model/history_model.h"
+#include "db/db_executor.h"
+#include "db/query_metrics.h"
 #include "device/device_repo.h"
 
 #include <QFutureWatcher>
 #include <QVariant>
-#include <QtConcurrent>
+#include <algorithm>
+#include <iterator>
 #include <utility>
 
 namespace qml_model {
-HistoryModel::HistoryModel(QObject *parent) : QAbstractListModel(parent) {}
+HistoryModel::HistoryModel(QObject *parent) : KeyedListModel(parent) {}
 
 int HistoryModel::rowCount(const QModelIndex &parent) const {
   if (parent.isValid())
@@ -37,6 +40,20 @@ QVariant HistoryModel::data(const QModelIndex &index, int role) const {
     return item.status;
   case SummaryRole:
     return item.summary;
+  case CcuCountRole:
+    return item.ccuCount;
+  case FaultCcuCountRole:
+    return item.faultCcuCount;
+  case AcContactorFaultsRole:
+    return item.acContactorFaults;
+  case ParallelContactorFaultsRole:
+    return item.parallelContactorFaults;
+  case FanFaultsRole:
+    return item.fanFaults;
+  case GunFaultsRole:
+    return item.gunFaults;
+  case FaultMaskRole:
+    return item.faultMask;
   default:
     return QVariant();
   }
@@ -50,12 +67,138 @@ QHash<int, QByteArray> HistoryModel::roleNames() const {
   roles[TimestampDisplayRole] = "timestampDisplay";
   roles[StatusRole] = "status";
   roles[SummaryRole] = "summary";
+  roles[CcuCountRole] = "ccuCount";
+  roles[FaultCcuCountRole] = "faultCcuCount";
+  roles[AcContactorFaultsRole] = "acContactorFaults";
+  roles[ParallelContactorFaultsRole] = "parallelContactorFaults";
+  roles[FanFaultsRole] = "fanFaults";
+  roles[GunFaultsRole] = "gunFaults";
+  roles[FaultMaskRole] = "faultMask";
   return roles;
 }
 
+bool HistoryModel::canFetchMore(const QModelIndex &parent) const {
+  if (parent.isValid())
+    return false;
+  return has_more_ && !loading_ && filter_ != nullptr;
+}
+
+void HistoryModel::fetchMore(const QModelIndex &parent) {
+  if (!canFetchMore(parent) || items_.empty())
+    return;
+
+  const auto &last = items_.back();
+  device::HistoryCursor cursor;
+  cursor.created_at =
+      last.timestamp.toString("yyyy-MM-dd HH:mm:ss").toStdString();
+  cursor.id = last.recordId.toLongLong();
+  requestPage(cursor);
+}
+
 void HistoryModel::load(const QString &deviceId, int limit) {
-  if (loading_)
+  auto filter = std::make_shared<device::HistoryFilter>();
+  filter->equip_nos.push_back(deviceId.toStdString());
+  filter->limit = limit > 0 ? limit : 10;
+
+  // 同一设备刷新时保留当前列表，避免闪烁
+  const bool same_device = filter_ != nullptr &&
+                           filter_->equip_nos == filter->equip_nos;
+  applyFilter(std::move(filter), same_device);
+}
+
+void HistoryModel::search(const QVariantMap &map) {
+  auto filter = std::make_shared<device::HistoryFilter>();
+
+  auto to_strings = [&map](const char *key) {
+    std::vector<std::string> out;
+    for (const auto &value : map.value(key).toStringList()) {
+      if (!value.isEmpty())
+        out.push_back(value.toStdString());
+    }
+    return out;
+  };
+
+  // 接受 QML Date 或 "yyyy-MM-dd[ HH:mm:ss]"；date_only 表示输入不含时间部分
+  auto to_datetime = [&map](const char *key,
+                            bool *date_only) -> std::optional<QDateTime> {
+    *date_only = false;
+    const QVariant value = map.value(key);
+    if (!value.isValid() || value.isNull())
+      return std::nullopt;
+    if (value.canConvert<QDateTime>() && value.typeId() != QMetaType::QString)
+      return value.toDateTime();
+    const QString text = value.toString().trimmed();
+    if (text.isEmpty())
+      return std::nullopt;
+    QDateTime dt = QDateTime::fromString(text, "yyyy-MM-dd HH:mm:ss");
+    if (!dt.isValid()) {
+      dt = QDateTime::fromString(text, "yyyy-MM-dd");
+      *date_only = dt.isValid();
+    }
+    return dt;
+  };
+
+  filter->equip_nos = to_strings("deviceIds");
+  filter->statuses = to_strings("statuses");
+  filter->check_categories = to_strings("categories");
+  filter->trigger_sources = to_strings("triggerSources");
+  filter->summary_text = map.value("text").toString().trimmed().toStdString();
+  filter->limit = map.value("limit", 20).toInt();
+
+  // end_of_day：只给日期的截止条件包含当天，右开界取次日 00:00:00
+  auto parse_bound = [&](const char *key, bool end_of_day,
+                         std::optional<std::string> &out) {
+    bool date_only = false;
+    auto dt = to_datetime(key, &date_only);
+    if (!dt)
+      return true;
+    if (!dt->isValid()) {
+      setLastError(tr("时间格式无效: %1").arg(map.value(key).toString()));
+      return false;
+    }
+    if (end_of_day && date_only)
+      *dt = dt->addDays(1);
+    out = dt->toString("yyyy-MM-dd HH:mm:ss").toStdString();
+    return true;
+  };
+  if (!parse_bound("from", false, filter->from) ||
+      !parse_bound("to", true, filter->to))
+    return;
+
+  // 显式给出的空状态列表表示“不匹配任何状态”，不能按“不过滤”处理
+  if (map.contains("statuses") && filter->statuses.empty()) {
+    ++generation_;
+    filter_.reset();
+    setItems({});
+    setHasMore(false);
+    setLastError({});
+    setLoading(false);
     return;
+  }
+
+  applyFilter(std::move(filter), false);
+}
+
+void HistoryModel::applyFilter(
+    std::shared_ptr<const device::HistoryFilter> filter, bool keep_items) {
+  // 取代任何仍在进行中的请求
+  ++generation_;
+  if (!keep_items) {
+    // 条件变化时先清空，避免短暂显示与条件不符的记录
+    setItems({});
+  }
+  filter_ = std::move(filter);
+  setHasMore(false);
+  requestPage(std::nullopt);
+}
+
+void HistoryModel::requestPage(
+    const std::optional<device::HistoryCursor> &cursor) {
+  const bool append = cursor.has_value();
+  const auto generation = generation_;
+  auto filter = filter_;
+  const int limit = std::clamp(filter->limit, 1,
+                               device::DeviceRepo::kMaxHistoryLimit);
 
   setLastError({});
   setLoading(true);
@@ -64,24 +207,38 @@ void HistoryModel::load(const QString &deviceId, int limit) {
 
   connect(watcher,
           &QFutureWatcher<absl::StatusOr<std::vector<HistoryItem>>>::finished,
-          this, [this, watcher]() {
+          this, [this, watcher, generation, append, limit]() {
+            watcher->deleteLater();
+            if (generation != generation_) {
+              // 已被更新的请求取代
+              return;
+            }
+
             auto result = watcher->future().result();
             if (!result.ok()) {
               setLastError(QString::fromStdString(result.status().ToString()));
               setLoading(false);
-              watcher->deleteLater();
               return;
             }
 
             auto items = std::move(result).value();
-            setItems(std::move(items));
+            const bool has_more = static_cast<int>(items.size()) >= limit;
+            if (append) {
+              appendItems(std::move(items));
+            } else {
+              setItems(std::move(items));
+            }
+            setHasMore(has_more);
             setLoading(false);
-            watcher->deleteLater();
           });
 
-  watcher->setFuture(QtConcurrent::run([deviceId, limit]() {
-    return device::DeviceRepo::GetHistoryItems(deviceId, limit);
-  }));
+  watcher->setFuture(db::DbExecutor::Submit(
+      db::QueryPriority::kInteractive, [filter, cursor]() {
+        db::ScopedQueryOrigin origin("HistoryPage");
+        device::HistoryFilter page = *filter;
+        page.before = cursor;
+        return device::DeviceRepo::SearchHistory(page);
+      }));
 }
 
 QVariant HistoryModel::get(int row) const {
@@ -96,22 +253,135 @@ QVariant HistoryModel::get(int row) const {
   map["timestampDisplay"] = item.timestamp.toString(Qt::ISODate);
   map["status"] = item.status;
   map["summary"] = item.summary;
+  map["ccuCount"] = item.ccuCount;
+  map["faultCcuCount"] = item.faultCcuCount;
+  map["acContactorFaults"] = item.acContactorFaults;
+  map["parallelContactorFaults"] = item.parallelContactorFaults;
+  map["fanFaults"] = item.fanFaults;
+  map["gunFaults"] = item.gunFaults;
+  map["faultMask"] = item.faultMask;
   return map;
 }
 
+void HistoryModel::prependRecord(const HistoryItem &item,
+                                 const QString &checkCategory,
+                                 const QString &triggerSource) {
+  if (filter_ == nullptr || !Accepts(*filter_, item, checkCategory,
+                                     triggerSource))
+    return;
+  // 进行中的首页请求可能已包含该记录
+  const bool exists =
+      std::any_of(items_.begin(), items_.end(), [&](const HistoryItem &it) {
+        return it.recordId == item.recordId;
+      });
+  if (exists)
+    return;
+
+  beginInsertRows(QModelIndex(), 0, 0);
+  items_.insert(items_.begin(), item);
+  endInsertRows();
+
+  if (static_cast<int>(items_.size()) > kMaxLiveItems) {
+    const int first = kMaxLiveItems;
+    const int last = static_cast<int>(items_.size()) - 1;
+    beginRemoveRows(QModelIndex(), first, last);
+    items_.erase(items_.begin() + first, items_.end());
+    endRemoveRows();
+    // 被裁掉的记录仍可通过游标分页取回
+    setHasMore(true);
+  }
+}
+
+bool HistoryModel::Accepts(const device::HistoryFilter &filter,
+                           const HistoryItem &item,
+                           const QString &checkCategory,
+                           const QString &triggerSource) {
+  auto in = [](const std::vector<std::string> &values, const QString &value) {
+    return values.empty() ||
+           std::find(values.begin(), values.end(), value.toStdString()) !=
+               values.end();
+  };
+  if (!in(filter.equip_nos, item.deviceId) ||
+      !in(filter.statuses, item.status) ||
+      !in(filter.check_categories, checkCategory) ||
+      !in(filter.trigger_sources, triggerSource))
+    return false;
+
+  // 与 SearchHistory 相同的左闭右开区间，"yyyy-MM-dd HH:mm:ss" 字典序即时间序
+  const auto created_at =
+      item.timestamp.toString("yyyy-MM-dd HH:mm:ss").toStdString();
+  if (filter.from.has_value() && created_at < *filter.from)
+    return false;
+  if (filter.to.has_value() && created_at >= *filter.to)
+    return false;
+
+  // LIKE 在默认排序规则下不区分大小写
+  return filter.summary_text.empty() ||
+         item.summary.contains(QString::fromStdString(filter.summary_text),
+                               Qt::CaseInsensitive);
+}
+
 void HistoryModel::setLoading(bool v) {
   loading_ = v;
   emit loadingChanged();
 }
 
+void HistoryModel::setHasMore(bool v) {
+  if (has_more_ == v)
+    return;
+  has_more_ = v;
+  emit hasMoreChanged();
+}
+
 void HistoryModel::setLastError(const QString &message) {
   last_error_ = message;
   emit errorChanged(message);
 }
 
 void HistoryModel::setItems(std::vector<HistoryItem> &&items) {
-  beginResetModel();
-  items_ = std::move(items);
-  endResetModel();
+  applyKeyedDiff(
+      items_, std::move(items),
+      [](const HistoryItem &item) { return item.recordId; },
+      &HistoryModel::ChangedRoles);
+}
+
+QList<int> HistoryModel::ChangedRoles(const HistoryItem &before,
+                                      const HistoryItem &after) {
+  QList<int> roles;
+  if (before.deviceId != after.deviceId)
+    roles.append(DeviceIdRole);
+  if (before.timestamp != after.timestamp)
+    roles.append({TimestampRole, TimestampDisplayRole});
+  if (before.status != after.status)
+    roles.append(StatusRole);
+  if (before.summary != after.summary)
+    roles.append(SummaryRole);
+  if (before.ccuCount != after.ccuCount)
+    roles.append(CcuCountRole);
+  if (before.faultCcuCount != after.faultCcuCount)
+    roles.append(FaultCcuCountRole);
+  if (before.acContactorFaults != after.acContactorFaults)
+    roles.append(AcContactorFaultsRole);
+  if (before.parallelContactorFaults != after.parallelContactorFaults)
+    roles.append(ParallelContactorFaultsRole);
+  if (before.fanFaults != after.fanFaults)
+    roles.append(FanFaultsRole);
+  if (before.gunFaults != after.gunFaults)
+    roles.append(GunFaultsRole);
+  if (before.faultMask != after.faultMask)
+    roles.append(FaultMaskRole);
+  return roles;
+}
+
+void HistoryModel::appendItems(std::vector<HistoryItem> &&items) {
+  if (items.empty())
+    return;
+
+  const int first = static_cast<int>(items_.size());
+  const int last = first + static_cast<int>(items.size()) - 1;
+  beginInsertRows(QModelIndex(), first, last);
+  items_.insert(items_.end(), std::make_move_iterator(items.begin()),
+                std::make_move_iterator(items.end()));
+  endInsertRows();
 }
 } // namespace qml_model
\ No newline at end of file
@@ -1,16 +1,20 @@
 #include "model/pile_model.h"
+#include "db/db_executor.h"
+#include "db/query_metrics.h"
+#include "device/ccu_fields.h"
 #include "device/device_object.h"
 #include "device/device_repo.h"
+#include "model/ccu_value.h"
 
 #include <QFutureWatcher>
 #include <QVariant>
-#include <QtConcurrent>
+#include <bit>
 #include <glog/logging.h>
 #include <utility>
 
 namespace qml_model {
 
-PileModel::PileModel(QObject *parent) : QAbstractListModel(parent) {}
+PileModel::PileModel(QObject *parent) : KeyedListModel(parent) {}
 
 int PileModel::rowCount(const QModelIndex &parent) const {
   if (parent.isValid())
@@ -27,81 +31,40 @@ QVariant PileModel::data(const QModelIndex &index, int role) const {
     return QVariant();
 
   const auto &item = items_[row];
+  const int flag = role - FirstFlagRole;
+  if (flag >= 0 && flag < static_cast<int>(device::kCcuFieldCount)) {
+    return device::kCcuFields[flag].get(item);
+  }
+
   switch (role) {
+  case FlagsRole:
+    return item.flags;
+  case AcContactorFlagsRole:
+    return item.flags &
+           device::CcuCategoryMask(device::CcuCategory::AcContactor);
+  case ParallelContactorFlagsRole:
+    return item.flags &
+           device::CcuCategoryMask(device::CcuCategory::ParallelContactor);
+  case FanFlagsRole:
+    return item.flags & device::CcuCategoryMask(device::CcuCategory::Fan);
+  case GunFlagsRole:
+    return item.flags & device::CcuCategoryMask(device::CcuCategory::Gun);
+  case FaultMaskRole:
+    return item.flags & device::ccu_flag::kAllFaults;
+  case FaultCountRole:
+    return item.faultCount();
+  case CcuRole:
+    return QVariant::fromValue(CcuValue(item));
   case CcuIndexRole:
     return item.index;
   case DeviceIdRole:
-    return QString::fromStdString(item.device_id);
+    return QString::fromStdString(item.device_id());
   case DeviceNameRole:
-    return QString::fromStdString(item.device_name);
+    return QString::fromStdString(item.device_name());
   case DeviceTypeRole:
-    return QString::fromStdString(item.device_type);
+    return QString::fromStdString(item.device_type());
   case LastCheckTimeRole:
-    return QString::fromStdString(item.last_check_time);
-  case Ac1StuckRole:
-    return item.ac_contactor_1.contactor1_stuck;
-  case Ac1RefuseRole:
-    return item.ac_contactor_1.contactor1_refuse;
-  case Ac2StuckRole:
-    return item.ac_contactor_2.contactor1_stuck;
-  case Ac2RefuseRole:
-    return item.ac_contactor_2.contactor1_refuse;
-  case ParPosStuckRole:
-    return item.parallel_contactor.positive_stuck;
-  case ParPosRefuseRole:
-    return item.parallel_contactor.positive_refuse;
-  case ParNegStuckRole:
-    return item.parallel_contactor.negative_stuck;
-  case ParNegRefuseRole:
-    return item.parallel_contactor.negative_refuse;
-  case Fan1StoppedRole:
-    return item.fan_1.stopped;
-  case Fan1RotatingRole:
-    return item.fan_1.rotating;
-  case Fan2StoppedRole:
-    return item.fan_2.stopped;
-  case Fan2RotatingRole:
-    return item.fan_2.rotating;
-  case Fan3StoppedRole:
-    return item.fan_3.stopped;
-  case Fan3RotatingRole:
-    return item.fan_3.rotating;
-  case Fan4StoppedRole:
-    return item.fan_4.stopped;
-  case Fan4RotatingRole:
-    return item.fan_4.rotating;
-  case GunAPosStuckRole:
-    return item.gun_a.positive_contactor_stuck;
-  case GunAPosRefuseRole:
-    return item.gun_a.positive_contactor_refuse;
-  case GunANegStuckRole:
-    return item.gun_a.negative_contactor_stuck;
-  case GunANegRefuseRole:
-    return item.gun_a.negative_contactor_refuse;
-  case GunAUnlockedRole:
-    return item.gun_a.unlocked;
-  case GunALockedRole:
-    return item.gun_a.locked;
-  case GunAAux12Role:
-    return item.gun_a.aux_power_12v;
-  case GunAAux24Role:
-    return item.gun_a.aux_power_24v;
-  case GunBPosStuckRole:
-    return item.gun_b.positive_contactor_stuck;
-  case GunBPosRefuseRole:
-    return item.gun_b.positive_contactor_refuse;
-  case GunBNegStuckRole:
-    return item.gun_b.negative_contactor_stuck;
-  case GunBNegRefuseRole:
-    return item.gun_b.negative_contactor_refuse;
-  case GunBUnlockedRole:
-    return item.gun_b.unlocked;
-  case GunBLockedRole:
-    return item.gun_b.locked;
-  case GunBAux12Role:
-    return item.gun_b.aux_power_12v;
-  case GunBAux24Role:
-    return item.gun_b.aux_power_24v;
+    return QString::fromStdString(item.last_check_time());
   default:
     return QVariant();
   }
@@ -114,66 +77,60 @@ QHash<int, QByteArray> PileModel::roleNames() const {
   roles[DeviceNameRole] = "deviceName";
   roles[DeviceTypeRole] = "deviceType";
   roles[LastCheckTimeRole] = "lastCheckTime";
-  roles[Ac1StuckRole] = "ac1_stuck";
-  roles[Ac1RefuseRole] = "ac1_refuse";
-  roles[Ac2StuckRole] = "ac2_stuck";
-  roles[Ac2RefuseRole] = "ac2_refuse";
-  roles[ParPosStuckRole] = "par_pos_stuck";
-  roles[ParPosRefuseRole] = "par_pos_refuse";
-  roles[ParNegStuckRole] = "par_neg_stuck";
-  roles[ParNegRefuseRole] = "par_neg_refuse";
-  roles[Fan1StoppedRole] = "fan1_stopped";
-  roles[Fan1RotatingRole] = "fan1_rotating";
-  roles[Fan2StoppedRole] = "fan2_stopped";
-  roles[Fan2RotatingRole] = "fan2_rotating";
-  roles[Fan3StoppedRole] = "fan3_stopped";
-  roles[Fan3RotatingRole] = "fan3_rotating";
-  roles[Fan4StoppedRole] = "fan4_stopped";
-  roles[Fan4RotatingRole] = "fan4_rotating";
-  roles[GunAPosStuckRole] = "gunA_pos_stuck";
-  roles[GunAPosRefuseRole] = "gunA_pos_refuse";
-  roles[GunANegStuckRole] = "gunA_neg_stuck";
-  roles[GunANegRefuseRole] = "gunA_neg_refuse";
-  roles[GunAUnlockedRole] = "gunA_unlocked";
-  roles[GunALockedRole] = "gunA_locked";
-  roles[GunAAux12Role] = "gunA_aux12";
-  roles[GunAAux24Role] = "gunA_aux24";
-  roles[GunBPosStuckRole] = "gunB_pos_stuck";
-  roles[GunBPosRefuseRole] = "gunB_pos_refuse";
-  roles[GunBNegStuckRole] = "gunB_neg_stuck";
-  roles[GunBNegRefuseRole] = "gunB_neg_refuse";
-  roles[GunBUnlockedRole] = "gunB_unlocked";
-  roles[GunBLockedRole] = "gunB_locked";
-  roles[GunBAux12Role] = "gunB_aux12";
-  roles[GunBAux24Role] = "gunB_aux24";
+  roles[FlagsRole] = "flags";
+  roles[AcContactorFlagsRole] = "acContactorFlags";
+  roles[ParallelContactorFlagsRole] = "parallelContactorFlags";
+  roles[FanFlagsRole] = "fanFlags";
+  roles[GunFlagsRole] = "gunFlags";
+  roles[FaultMaskRole] = "faultMask";
+  roles[FaultCountRole] = "faultCount";
+  roles[CcuRole] = "ccu";
+  device::ForEachCcuField([&roles](const device::CcuFieldDesc &field) {
+    roles[FirstFlagRole + field.redis_index] =
+        QByteArray(field.role_name.data(),
+                   static_cast<int>(field.role_name.size()));
+  });
   return roles;
 }
 
+QVariantMap PileModel::flagBits() {
+  static const QVariantMap bits = [] {
+    QVariantMap map;
+    device::ForEachCcuField([&map](const device::CcuFieldDesc &field) {
+      map.insert(QString::fromLatin1(field.role_name.data(),
+                                     static_cast<int>(field.role_name.size())),
+                 field.redis_index);
+    });
+    return map;
+  }();
+  return bits;
+}
+
+int PileModel::faultFieldCount() { return device::CcuFaultFieldCount(); }
+
 void PileModel::loadDemo() {
   std::vector<device::CCUAttributes> demo;
 
+  auto meta = std::make_shared<device::CcuRecordMeta>();
+  meta->device_id = "DEMO-0001";
+  meta->device_type = "PILE";
+
   device::CCUAttributes first;
   first.index = 1;
-  first.device_id = "DEMO-0001";
-  first.device_type = "PILE";
-  first.last_check_time = "";
-  first.ac_contactor_2.contactor1_stuck = true;
-  first.parallel_contactor.negative_refuse = true;
-  first.fan_3.stopped = true;
-  first.gun_b.positive_contactor_refuse = true;
+  first.meta = meta;
+  first.flags = device::ccu_flag::kAc2Stuck | device::ccu_flag::kParNegRefuse |
+                device::ccu_flag::kFan3Stopped |
+                device::ccu_flag::kGunBPosRefuse;
   demo.push_back(first);
 
   device::CCUAttributes second;
   second.index = 2;
-  second.device_id = "DEMO-0001";
-  second.device_type = "PILE";
-  second.last_check_time = "";
-  second.ac_contactor_1.contactor1_stuck = true;
-  second.ac_contactor_1.contactor1_refuse = true;
-  second.gun_b.unlocked = true;
+  second.meta = meta;
+  second.flags = device::ccu_flag::kAc1Stuck | device::ccu_flag::kAc1Refuse |
+                 device::ccu_flag::kGunBUnlocked;
   demo.push_back(second);
 
-  resetWith(std::move(demo));
+  applyItems(std::move(demo));
 }
 
 void PileModel::loadFromHistory(const QString &recordId) {
@@ -184,13 +141,49 @@ void PileModel::loadFromDevice(const QString &deviceId) {
   loadAsyncByDeviceId(deviceId);
 }
 
-void PileModel::resetWith(std::vector<device::CCUAttributes> &&items) {
-  beginResetModel();
-  items_ = std::move(items);
-  endResetModel();
+void PileModel::applyItems(std::vector<device::CCUAttributes> &&items) {
+  applyKeyedDiff(
+      items_, std::move(items),
+      [](const device::CCUAttributes &item) { return item.index; },
+      &PileModel::ChangedRoles);
   emit countChanged();
 }
 
+QList<int> PileModel::ChangedRoles(const device::CCUAttributes &before,
+                                   const device::CCUAttributes &after) {
+  QList<int> roles;
+  if (before.device_id() != after.device_id())
+    roles.append(DeviceIdRole);
+  if (before.device_name() != after.device_name())
+    roles.append(DeviceNameRole);
+  if (before.device_type() != after.device_type())
+    roles.append(DeviceTypeRole);
+  if (before.last_check_time() != after.last_check_time())
+    roles.append(LastCheckTimeRole);
+
+  const std::uint32_t diff = before.flags ^ after.flags;
+  if (diff == 0)
+    return roles;
+
+  roles.append({FlagsRole, CcuRole});
+  if ((diff & device::CcuCategoryMask(device::CcuCategory::AcContactor)) != 0)
+    roles.append(AcContactorFlagsRole);
+  if ((diff &
+       device::CcuCategoryMask(device::CcuCategory::ParallelContactor)) != 0)
+    roles.append(ParallelContactorFlagsRole);
+  if ((diff & device::CcuCategoryMask(device::CcuCategory::Fan)) != 0)
+    roles.append(FanFlagsRole);
+  if ((diff & device::CcuCategoryMask(device::CcuCategory::Gun)) != 0)
+    roles.append(GunFlagsRole);
+  if ((diff & device::ccu_flag::kAllFaults) != 0)
+    roles.append({FaultMaskRole, FaultCountRole});
+  // 逐位 role 只通知真正翻转的位
+  for (std::uint32_t bits = diff; bits != 0; bits &= bits - 1) {
+    roles.append(FirstFlagRole + std::countr_zero(bits));
+  }
+  return roles;
+}
+
 void PileModel::setLoading(bool loading) {
   if (loading_ == loading)
     return;
@@ -229,13 +222,17 @@ void PileModel::loadAsyncByRecordId(const QString &recordId) {
             }
 
             auto items = std::move(result).value();
-            resetWith(std::move(items));
+            applyItems(std::move(items));
             setLoading(false);
             watcher->deleteLater();
           });
 
-  watcher->setFuture(QtConcurrent::run(
-      [recordId]() { return device::DeviceRepo::GetPileItems(recordId); }));
+  watcher->setFuture(db::DbExecutor::Submit(
+      db::QueryPriority::kInteractive,
+      [recordId]() {
+        db::ScopedQueryOrigin origin("PileDetail.history");
+        return device::DeviceRepo::GetPileItems(recordId);
+      }));
 }
 
 void PileModel::loadAsyncByDeviceId(const QString &deviceId) {
@@ -243,6 +240,14 @@ void PileModel::loadAsyncByDeviceId(const QString &deviceId) {
     return;
   }
 
+  // 已被 DetailPrefetcher 预热：同步应用，不经过 DbExecutor
+  if (auto cached =
+          device::DeviceRepo::PeekLatestPileDetails(deviceId.toStdString())) {
+    setLastError({});
+    applyItems(std::vector<device::CCUAttributes>(*cached));
+    return;
+  }
+
   setLastError({});
   setLoading(true);
 
@@ -263,14 +268,16 @@ void PileModel::loadAsyncByDeviceId(const QString &deviceId) {
             }
 
             auto items = std::move(result).value();
-            resetWith(std::move(items));
+            applyItems(std::move(items));
             setLoading(false);
             watcher->deleteLater();
           });
 
-  watcher->setFuture(QtConcurrent::run([deviceId]() {
-    return device::DeviceRepo::GetLatestPileItems(deviceId);
-  }));
+  watcher->setFuture(
+      db::DbExecutor::Submit(db::QueryPriority::kInteractive, [deviceId]() {
+        db::ScopedQueryOrigin origin("PileDetail.latest");
+        return device::DeviceRepo::GetLatestPileItems(deviceId);
+      }));
 }
 
 } // namespace qml_model
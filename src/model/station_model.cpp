@@ -0,0 +1,360 @@
+#include "model/station_model.h"
+
+#include <algorithm>
+
+#include "model/device_model.h"
+
+namespace qml_model {
+
+namespace {
+// 一次插入超过该行数时整体重建，比逐台 attach（逐行通知）更快
+constexpr int kBulkInsertThreshold = 64;
+
+const QList<int> kCounterRoles = {
+    StationModel::DeviceCountRole, StationModel::OnlineCountRole,
+    StationModel::OfflineCountRole, StationModel::CheckingCountRole,
+    StationModel::FailedCountRole};
+
+// rows_ 按站点编号有序，二分查找用
+struct StationNoLess {
+  template <typename Node>
+  bool operator()(const std::unique_ptr<Node> &node,
+                  const std::string &key) const {
+    return node->station_no < key;
+  }
+};
+} // namespace
+
+StationModel::StationModel(DeviceModel *source, QObject *parent)
+    : QAbstractItemModel(parent), source_(source) {
+  connect(source_, &QAbstractItemModel::rowsInserted, this,
+          &StationModel::onRowsInserted);
+  connect(source_, &QAbstractItemModel::rowsAboutToBeRemoved, this,
+          &StationModel::onRowsAboutToBeRemoved);
+  connect(source_, &QAbstractItemModel::dataChanged, this,
+          &StationModel::onDataChanged);
+  connect(source_, &QAbstractItemModel::modelReset, this,
+          &StationModel::rebuildFromSource);
+  connect(source_, &QAbstractItemModel::layoutChanged, this,
+          &StationModel::rebuildFromSource);
+  rebuildFromSource();
+}
+
+StationModel::~StationModel() = default;
+
+// ============ QAbstractItemModel 接口 ============
+// 站点行的 internalPointer 为空，设备行的 internalPointer 指向所属站点
+QModelIndex StationModel::index(int row, int column,
+                                const QModelIndex &parent) const {
+  if (column != 0 || row < 0)
+    return {};
+  if (!parent.isValid()) {
+    return row < stationCount() ? createIndex(row, 0, nullptr)
+                                : QModelIndex();
+  }
+  if (parent.internalPointer() != nullptr ||
+      parent.row() >= stationCount())
+    return {};
+  auto *station = rows_[parent.row()].get();
+  if (row >= static_cast<int>(station->devices.size()))
+    return {};
+  return createIndex(row, 0, station);
+}
+
+QModelIndex StationModel::parent(const QModelIndex &child) const {
+  if (!child.isValid() || child.internalPointer() == nullptr)
+    return {};
+  return stationIndex(
+      static_cast<const StationNode *>(child.internalPointer()));
+}
+
+int StationModel::rowCount(const QModelIndex &parent) const {
+  if (!parent.isValid())
+    return stationCount();
+  if (parent.internalPointer() != nullptr || parent.row() >= stationCount())
+    return 0;
+  return static_cast<int>(rows_[parent.row()]->devices.size());
+}
+
+int StationModel::columnCount(const QModelIndex & /*parent*/) const {
+  return 1;
+}
+
+QVariant StationModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid())
+    return {};
+
+  // 设备行：转发给 DeviceModel
+  if (const auto *station =
+          static_cast<const StationNode *>(index.internalPointer())) {
+    if (role == IsStationRole)
+      return false;
+    if (role == StationNoRole)
+      return QString::fromStdString(station->station_no);
+    const auto handle = station->devices[index.row()];
+    const int source_row = source_->snapshot()->rowOf(handle);
+    if (source_row < 0)
+      return {};
+    return source_->data(source_->index(source_row), role);
+  }
+
+  if (index.row() >= stationCount())
+    return {};
+  const auto &node = *rows_[index.row()];
+  switch (role) {
+  case Qt::DisplayRole:
+  case StationNoRole:
+    return QString::fromStdString(node.station_no);
+  case IsStationRole:
+    return true;
+  case DeviceCountRole:
+    return node.counters.total;
+  case OnlineCountRole:
+    return node.counters.online;
+  case OfflineCountRole:
+    return node.counters.total - node.counters.online;
+  case CheckingCountRole:
+    return node.counters.checking;
+  case FailedCountRole:
+    return node.counters.failed;
+  }
+  return {};
+}
+
+QHash<int, QByteArray> StationModel::roleNames() const {
+  QHash<int, QByteArray> roles = source_->roleNames();
+  roles[IsStationRole] = "isStation";
+  // 与设备的 stationNo 同名：站点行和设备行都能取到所属站点
+  roles[StationNoRole] = "stationNo";
+  roles[DeviceCountRole] = "deviceCount";
+  roles[OnlineCountRole] = "onlineCount";
+  roles[OfflineCountRole] = "offlineCount";
+  roles[CheckingCountRole] = "checkingCount";
+  roles[FailedCountRole] = "failedCount";
+  return roles;
+}
+
+// ============ 站点节点 ============
+void StationModel::Count(Counters &counters, const Member &member, int sign) {
+  counters.total += sign;
+  counters.online += member.online ? sign : 0;
+  counters.checking += member.checking ? sign : 0;
+  counters.failed += member.failed ? sign : 0;
+}
+
+QModelIndex StationModel::stationIndex(const StationNode *station) const {
+  return createIndex(station->row, 0, nullptr);
+}
+
+StationModel::Member *StationModel::member(device::DeviceHandle handle) {
+  if (handle >= members_.size() || members_[handle].station == nullptr)
+    return nullptr;
+  return &members_[handle];
+}
+
+StationModel::StationNode *
+StationModel::findStation(const std::string &station_no) const {
+  auto it = std::lower_bound(rows_.begin(), rows_.end(), station_no,
+                             StationNoLess());
+  return it != rows_.end() && (*it)->station_no == station_no ? it->get()
+                                                               : nullptr;
+}
+
+StationModel::StationNode *
+StationModel::emplaceStation(const std::string &station_no) {
+  auto it = std::lower_bound(rows_.begin(), rows_.end(), station_no,
+                             StationNoLess());
+  const int row = static_cast<int>(it - rows_.begin());
+  auto *station = rows_.insert(it, std::make_unique<StationNode>())->get();
+  station->station_no = station_no;
+  for (int i = row; i < stationCount(); ++i) {
+    rows_[i]->row = i;
+  }
+  return station;
+}
+
+StationModel::StationNode *
+StationModel::insertStation(const std::string &station_no) {
+  const auto row = static_cast<int>(
+      std::lower_bound(rows_.begin(), rows_.end(), station_no,
+                       StationNoLess()) -
+      rows_.begin());
+  beginInsertRows(QModelIndex(), row, row);
+  auto *station = emplaceStation(station_no);
+  endInsertRows();
+  emit stationCountChanged();
+  return station;
+}
+
+void StationModel::removeStation(StationNode *station) {
+  const int row = station->row;
+  beginRemoveRows(QModelIndex(), row, row);
+  rows_.erase(rows_.begin() + row);
+  for (int i = row; i < stationCount(); ++i) {
+    rows_[i]->row = i;
+  }
+  endRemoveRows();
+  emit stationCountChanged();
+}
+
+// ============ 设备归属 ============
+void StationModel::attach(const device::PileDevice &device) {
+  const auto handle = device.Handle();
+  if (members_.size() <= handle) {
+    members_.resize(handle + 1);
+  }
+
+  const auto &station_no = device.Attributes().station_no;
+  auto *station = findStation(station_no);
+  if (station == nullptr) {
+    station = insertStation(station_no);
+  }
+
+  auto &m = members_[handle];
+  m.station = station;
+  m.child_row = static_cast<int>(station->devices.size());
+  m.online = device.IsOnline();
+  m.checking = device.IsSelfChecking();
+  m.failed =
+      device.LastSelfCheck().status == device::SelfCheckStatus::Failed;
+
+  const QModelIndex parent = stationIndex(station);
+  beginInsertRows(parent, m.child_row, m.child_row);
+  station->devices.push_back(handle);
+  endInsertRows();
+
+  Count(station->counters, m, +1);
+  emit dataChanged(parent, parent, kCounterRoles);
+}
+
+void StationModel::detach(device::DeviceHandle handle) {
+  auto *m = member(handle);
+  if (m == nullptr)
+    return;
+  auto *station = m->station;
+  const int child_row = m->child_row;
+
+  beginRemoveRows(stationIndex(station), child_row, child_row);
+  station->devices.erase(station->devices.begin() + child_row);
+  for (int i = child_row; i < static_cast<int>(station->devices.size()); ++i) {
+    members_[station->devices[i]].child_row = i;
+  }
+  endRemoveRows();
+
+  Count(station->counters, *m, -1);
+  *m = Member();
+
+  if (station->devices.empty()) {
+    removeStation(station);
+  } else {
+    const QModelIndex parent = stationIndex(station);
+    emit dataChanged(parent, parent, kCounterRoles);
+  }
+}
+
+void StationModel::rebuildFromSource() {
+  beginResetModel();
+  rows_.clear();
+  members_.clear();
+
+  const auto table = source_->snapshot();
+  for (int row = 0; row < table->size(); ++row) {
+    const auto device = table->at(row);
+    if (!device)
+      continue;
+    const auto handle = device->Handle();
+    if (members_.size() <= handle) {
+      members_.resize(handle + 1);
+    }
+    // 重置期间不发行级信号，直接构建
+    const auto &station_no = device->Attributes().station_no;
+    auto *station = findStation(station_no);
+    if (station == nullptr) {
+      station = emplaceStation(station_no);
+    }
+    auto &m = members_[handle];
+    m.station = station;
+    m.child_row = static_cast<int>(station->devices.size());
+    m.online = device->IsOnline();
+    m.checking = device->IsSelfChecking();
+    m.failed =
+        device->LastSelfCheck().status == device::SelfCheckStatus::Failed;
+    station->devices.push_back(handle);
+    Count(station->counters, m, +1);
+  }
+  endResetModel();
+  emit stationCountChanged();
+}
+
+// ============ 源模型增量变化 ============
+void StationModel::onRowsInserted(const QModelIndex &parent, int first,
+                                  int last) {
+  if (parent.isValid())
+    return;
+  if (last - first + 1 > kBulkInsertThreshold) {
+    rebuildFromSource();
+    return;
+  }
+  const auto table = source_->snapshot();
+  for (int row = first; row <= last; ++row) {
+    if (const auto device = table->at(row)) {
+      attach(*device);
+    }
+  }
+}
+
+void StationModel::onRowsAboutToBeRemoved(const QModelIndex &parent,
+                                          int first, int last) {
+  if (parent.isValid())
+    return;
+  // 此时源模型仍是删除前的表
+  const auto table = source_->snapshot();
+  for (int row = first; row <= last; ++row) {
+    if (const auto device = table->at(row)) {
+      detach(device->Handle());
+    }
+  }
+}
+
+void StationModel::onDataChanged(const QModelIndex &top_left,
+                                 const QModelIndex &bottom_right,
+                                 const QList<int> &roles) {
+  const auto table = source_->snapshot();
+  for (int row = top_left.row(); row <= bottom_right.row(); ++row) {
+    const auto device = table->at(row);
+    if (!device)
+      continue;
+    auto *m = member(device->Handle());
+    if (m == nullptr)
+      continue;
+
+    // 换站（设备表同步时可能发生）：移出旧站点再加入新站点
+    if (m->station->station_no != device->Attributes().station_no) {
+      detach(device->Handle());
+      attach(*device);
+      continue;
+    }
+
+    Member updated = *m;
+    updated.online = device->IsOnline();
+    updated.checking = device->IsSelfChecking();
+    updated.failed =
+        device->LastSelfCheck().status == device::SelfCheckStatus::Failed;
+
+    auto *station = m->station;
+    const QModelIndex child = createIndex(m->child_row, 0, station);
+    emit dataChanged(child, child, roles);
+
+    // 只按差值调整计数，不遍历站点下的其他设备
+    const Counters before = station->counters;
+    Count(station->counters, *m, -1);
+    Count(station->counters, updated, +1);
+    *m = updated;
+    if (!(station->counters == before)) {
+      const QModelIndex parent = stationIndex(station);
+      emit dataChanged(parent, parent, kCounterRoles);
+    }
+  }
+}
+
+} // namespace qml_model
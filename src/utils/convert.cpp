@@ -0,0 +1,74 @@
+#include "utils/convert.h"
+#include "device/ccu_fields.h"
+
+#include <charconv>
+
+namespace utils {
+
+namespace {
+
+// 解析开头的十进制整数（与 std::stoi 一致：允许尾随字符），失败返回 false
+bool ParseLeadingInt(std::string_view text, int &value) {
+  const char *begin = text.data();
+  const char *end = begin + text.size();
+  while (begin != end && (*begin == ' ' || *begin == '\t')) {
+    ++begin;
+  }
+  auto [ptr, ec] = std::from_chars(begin, end, value);
+  return ec == std::errc() && ptr != begin;
+}
+
+} // namespace
+
+absl::StatusOr<device::CCUAttributes>
+ToCCUAttr(const std::unordered_map<std::string, std::string> &hash,
+          int index) {
+  if (hash.empty()) {
+    return absl::NotFoundError("Redis hash is empty");
+  }
+
+  device::CCUAttributes attributes;
+  attributes.index = index;
+
+  for (const auto &[field, value_str] : hash) {
+    const std::string_view name(field);
+    const auto delimiter_pos = name.find(';');
+    if (delimiter_pos == std::string_view::npos) {
+      // Field missing index delimiter, skip
+      continue;
+    }
+
+    int bit = -1;
+    if (!ParseLeadingInt(name.substr(0, delimiter_pos), bit) || bit < 0 ||
+        bit >= static_cast<int>(device::kCcuFieldCount)) {
+      continue;
+    }
+
+    int numeric_value = 0;
+    if (!ParseLeadingInt(value_str, numeric_value)) {
+      continue;
+    }
+
+    // 1 = 是，2 = 否
+    if (numeric_value == 1) {
+      attributes.flags |= device::kCcuFields[bit].mask();
+    } else if (numeric_value == 2) {
+      attributes.flags &= ~device::kCcuFields[bit].mask();
+    }
+  }
+  return attributes;
+}
+
+int ParseModuleIndex(std::string_view module_key) {
+  const auto pos = module_key.find_last_of('#');
+  if (pos == std::string_view::npos) {
+    return -1;
+  }
+  int index = -1;
+  const auto suffix = module_key.substr(pos + 1);
+  auto [ptr, ec] =
+      std::from_chars(suffix.data(), suffix.data() + suffix.size(), index);
+  return ec == std::errc() ? index : -1;
+}
+
+} // namespace utils
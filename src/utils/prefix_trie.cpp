@@ -0,0 +1,74 @@
+#include "utils/prefix_trie.h"
+
+#include <algorithm>
+
+namespace utils {
+
+namespace {
+bool ChildLess(const std::pair<char16_t, std::uint32_t> &entry, char16_t c) {
+  return entry.first < c;
+}
+} // namespace
+
+std::uint32_t PrefixTrie::child(std::uint32_t node, char16_t c) const {
+  const auto &children = nodes_[node].children;
+  auto it = std::lower_bound(children.begin(), children.end(), c, ChildLess);
+  return it != children.end() && it->first == c ? it->second : kNoNode;
+}
+
+void PrefixTrie::insert(std::u16string_view key, Id id) {
+  std::uint32_t node = 0;
+  for (const char16_t c : key) {
+    auto &children = nodes_[node].children;
+    auto it = std::lower_bound(children.begin(), children.end(), c, ChildLess);
+    if (it == children.end() || it->first != c) {
+      const auto next = static_cast<std::uint32_t>(nodes_.size());
+      children.insert(it, {c, next});
+      nodes_.emplace_back(); // 可能使 children 引用失效，之后不再使用
+      node = next;
+    } else {
+      node = it->second;
+    }
+    nodes_[node].ids.push_back(id);
+  }
+}
+
+void PrefixTrie::erase(std::u16string_view key, Id id) {
+  std::uint32_t node = 0;
+  for (const char16_t c : key) {
+    node = child(node, c);
+    if (node == kNoNode) {
+      return;
+    }
+    auto &ids = nodes_[node].ids;
+    // 只摘掉一个：同一 id 的另一个 key 可能共享这段前缀
+    auto it = std::find(ids.begin(), ids.end(), id);
+    if (it != ids.end()) {
+      *it = ids.back();
+      ids.pop_back();
+    }
+  }
+}
+
+const std::vector<PrefixTrie::Id> *
+PrefixTrie::find(std::u16string_view prefix) const {
+  if (prefix.empty()) {
+    return nullptr;
+  }
+  static const std::vector<Id> kEmpty;
+  std::uint32_t node = 0;
+  for (const char16_t c : prefix) {
+    node = child(node, c);
+    if (node == kNoNode) {
+      return &kEmpty;
+    }
+  }
+  return &nodes_[node].ids;
+}
+
+void PrefixTrie::clear() {
+  nodes_.clear();
+  nodes_.emplace_back();
+}
+
+} // namespace utils
@@ -0,0 +1,195 @@
+#include "watcher/device_sync_watcher.h"
+#include "db/db_executor.h"
+#include "db/query_metrics.h"
+#include <glog/logging.h>
+
+#include <vector>
+
+namespace watcher {
+
+DeviceSyncWatcher::DeviceSyncWatcher(qml_model::DeviceModel *device_model,
+                                     QObject *parent)
+    : QObject(parent), device_model_(device_model),
+      sync_timer_(new QTimer(this)) {
+  connect(sync_timer_, &QTimer::timeout, this, &DeviceSyncWatcher::syncNow);
+}
+
+DeviceSyncWatcher::~DeviceSyncWatcher() { stop(); }
+
+void DeviceSyncWatcher::start() {
+  if (running_.load()) {
+    LOG(WARNING) << "[DeviceSyncWatcher] Already running";
+    return;
+  }
+
+  running_.store(true);
+  sync_timer_->start(sync_interval_ms_);
+  emit runningChanged();
+
+  LOG(INFO) << "[DeviceSyncWatcher] Started with interval "
+            << sync_interval_ms_ << "ms";
+
+  syncNow();
+}
+
+void DeviceSyncWatcher::stop() {
+  if (!running_.load()) {
+    return;
+  }
+
+  sync_timer_->stop();
+  running_.store(false);
+  emit runningChanged();
+
+  LOG(INFO) << "[DeviceSyncWatcher] Stopped";
+}
+
+void DeviceSyncWatcher::setSyncIntervalMs(int ms) {
+  if (ms < 5000) {
+    ms = 5000; // 最小 5 秒
+  }
+  if (sync_interval_ms_ != ms) {
+    sync_interval_ms_ = ms;
+    if (running_.load()) {
+      sync_timer_->setInterval(ms);
+    }
+    emit syncIntervalMsChanged();
+  }
+}
+
+void DeviceSyncWatcher::syncNow() {
+  if (in_flight_.exchange(true)) {
+    return; // 上一轮尚未结束
+  }
+  db::DbExecutor::Submit(db::QueryPriority::kBackground, [this]() {
+    db::ScopedQueryOrigin origin("DeviceSync");
+    if (!syncOnce()) {
+      in_flight_.store(false);
+    }
+  });
+}
+
+bool DeviceSyncWatcher::syncOnce() {
+  if (device_model_ == nullptr) {
+    LOG(ERROR) << "[DeviceSyncWatcher] DeviceModel is null";
+    return false;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  auto table_checksum = device::DeviceRepo::GetPipeDeviceTableChecksum();
+  if (!table_checksum.ok()) {
+    LOG(WARNING) << "[DeviceSyncWatcher] 获取设备表校验失败: "
+                 << table_checksum.status().message();
+    return false;
+  }
+  if (has_baseline_ && table_checksum.value() == table_checksum_) {
+    return false;
+  }
+
+  auto row_checksums = device::DeviceRepo::GetPipeDeviceChecksums();
+  if (!row_checksums.ok()) {
+    LOG(WARNING) << "[DeviceSyncWatcher] 获取设备行校验失败: "
+                 << row_checksums.status().message();
+    return false;
+  }
+
+  std::unordered_map<std::string, uint32_t> current;
+  current.reserve(row_checksums->size());
+  for (const auto &checksum : row_checksums.value()) {
+    current.emplace(checksum.equip_no, checksum.crc);
+  }
+
+  // 基线：启动时设备已由 GetAllPipeDevices 全量加载，只需补齐集合差异；
+  // 之后：CRC 变化或新出现的行都需要重新拉取
+  std::vector<std::string> changed;
+  std::vector<std::string> removed;
+  if (!has_baseline_) {
+    for (const auto &[equip_no, crc] : current) {
+      if (!device_model_->hasDevice(equip_no)) {
+        changed.push_back(equip_no);
+      }
+    }
+    const auto table = device_model_->snapshot();
+    for (int row = 0; row < table->size(); ++row) {
+      const std::string equip_no = table->at(row)->Id();
+      if (current.count(equip_no) == 0) {
+        removed.push_back(equip_no);
+      }
+    }
+  } else {
+    for (const auto &[equip_no, crc] : current) {
+      auto it = row_checksums_.find(equip_no);
+      if (it == row_checksums_.end() || it->second != crc) {
+        changed.push_back(equip_no);
+      }
+    }
+    for (const auto &[equip_no, crc] : row_checksums_) {
+      if (current.count(equip_no) == 0) {
+        removed.push_back(equip_no);
+      }
+    }
+  }
+
+  std::vector<device::PileAttr> changed_attrs;
+  if (!changed.empty()) {
+    auto fetched = device::DeviceRepo::GetPipeDevicesByEquipNos(changed);
+    if (!fetched.ok()) {
+      // 不更新基线，下一轮重试
+      LOG(WARNING) << "[DeviceSyncWatcher] 拉取变化设备失败: "
+                   << fetched.status().message();
+      return false;
+    }
+    changed_attrs = std::move(fetched.value());
+  }
+
+  lock.unlock();
+
+  if (changed_attrs.empty() && removed.empty()) {
+    commitBaseline(table_checksum.value(), std::move(current));
+    return false;
+  }
+
+  LOG(INFO) << "[DeviceSyncWatcher] equipment_info 有变化: changed="
+            << changed_attrs.size() << ", removed=" << removed.size();
+
+  // 基线在主线程应用完成后才提交：应用未执行（如退出时队列被丢弃）时，
+  // 下一轮仍会与旧基线比较并重新下发这些变化
+  return QMetaObject::invokeMethod(
+      device_model_,
+      [this, changed_attrs = std::move(changed_attrs),
+       removed = std::move(removed), table_checksum = table_checksum.value(),
+       current = std::move(current)]() mutable {
+        int added = 0;
+        int updated = 0;
+        int removed_count = 0;
+        for (const auto &attrs : changed_attrs) {
+          if (device_model_->hasDevice(attrs.equip_no)) {
+            ++updated;
+          } else {
+            ++added;
+          }
+          device_model_->addDevice(attrs);
+        }
+        for (const auto &equip_no : removed) {
+          if (device_model_->removeDevice(equip_no)) {
+            ++removed_count;
+          }
+        }
+        commitBaseline(table_checksum, std::move(current));
+        in_flight_.store(false);
+        emit devicesSynced(added, updated, removed_count);
+      },
+      Qt::QueuedConnection);
+}
+
+void DeviceSyncWatcher::commitBaseline(
+    const device::DeviceTableChecksum &table_checksum,
+    std::unordered_map<std::string, uint32_t> row_checksums) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  has_baseline_ = true;
+  table_checksum_ = table_checksum;
+  row_checksums_ = std::move(row_checksums);
+}
+
+} // namespace watcher
@@ -1,5 +1,6 @@
 #include "watcher/online_status_watcher.h"
 #include "client/redis_client.h"
+#include "device/device_registry.h"
 #include <glog/logging.h>
 
 namespace watcher {
@@ -78,32 +79,38 @@ void OnlineStatusWatcher::pollAllDevices() {
     return;
   }
 
-  // 获取所有设备的快照
-  auto devices = device_model_->allDevices();
-  if (devices.empty()) {
+  // 获取设备表快照（O(1)，不复制设备列表）
+  const auto table = device_model_->snapshot();
+  if (table->size() == 0) {
     return;
   }
 
   int updated_count = 0;
 
-  for (const auto &device : devices) {
+  for (int row = 0; row < table->size(); ++row) {
+    const auto device = table->at(row);
     const auto &attrs = device->Attributes();
     // 目前只处理充电桩 PILE
     if (attrs.type != "PILE") {
       continue;
     }
 
-    bool is_online = queryOnlineStatus(attrs.station_no, attrs.equip_order);
+    const auto handle = device->Handle();
+    const auto keys = device::DeviceRegistry::Instance().keys(handle);
+    if (!keys) {
+      continue;
+    }
+
+    bool is_online = queryOnlineStatus(keys->online_key);
     bool was_online = device->IsOnline();
 
     // 只在状态发生变化时才更新
     if (is_online != was_online) {
-      const std::string equip_no = attrs.equip_no; // 拷贝用于 lambda 捕获
-      // 通过 invokeMethod 在主线程更新 Model
+      // 通过 invokeMethod 在主线程更新 Model（只捕获 4 字节句柄）
       QMetaObject::invokeMethod(
           device_model_,
-          [this, equip_no, is_online]() {
-            device_model_->updateOnlineStatus(equip_no, is_online);
+          [this, handle, is_online]() {
+            device_model_->updateOnlineStatus(handle, is_online);
           },
           Qt::QueuedConnection);
 
@@ -122,8 +129,7 @@ void OnlineStatusWatcher::pollAllDevices() {
 }
 
 // static
-bool OnlineStatusWatcher::queryOnlineStatus(const std::string &station_no,
-                                            int equip_order) {
+bool OnlineStatusWatcher::queryOnlineStatus(const std::string &key) {
   auto *redis = client::RedisClient::GetInstance();
   if (redis == nullptr || !redis->IsConnected()) {
     return false;
@@ -132,9 +138,7 @@ bool OnlineStatusWatcher::queryOnlineStatus(const std::string &station_no,
   // Redis Key 格式: objects:STA#{station_no}:PILE#{equip_order}
   // 示例: objects:STA#155261:PILE#1
   // Field: comm，值为 "true" 表示在线
-  std::string key =
-      "objects:STA#" + station_no + ":PILE#" + std::to_string(equip_order);
-
+  // key 由 DeviceRegistry 在设备注册时预先拼好
   auto value = redis->HGet(key, "comm");
   if (!value.has_value()) {
     // Key 或 Field 不存在，视为离线